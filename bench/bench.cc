@@ -0,0 +1,277 @@
+/*
+ * bench.cc - Compares stealing buffers against copying them (BT_COPY_BUFFERS)
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <bufferthief/slab.hh>
+#include <bufferthief/string.hh>
+
+// <bufferthief/vector.hh> is not implemented for MSVC STL yet
+#if !defined(_MSC_VER) || defined(BT_COPY_BUFFERS)
+#	define BENCH_VECTORS 1
+#	include <bufferthief/vector.hh>
+#else
+#	define BENCH_VECTORS 0
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::size_t allocations_ = 0;
+
+//! Number of times each workload is repeated; the fastest run is reported
+constexpr int rounds = 5;
+
+//! Upper bound on the bytes of input built for a single timed batch
+constexpr std::size_t batch_bytes = std::size_t{128} << 20;
+
+//! Maximum number of operations in a single timed batch
+constexpr std::size_t max_batch_size = 4096;
+
+//! Sizes in elements, from small strings up to many megabytes
+constexpr std::size_t sizes[] = {
+	0, 8, 15, 16, 22, 23, 64, 512,
+	std::size_t{4} << 10,
+	std::size_t{64} << 10,
+	std::size_t{1} << 20,
+	std::size_t{8} << 20
+};
+
+struct Result
+{
+	double ns_per_op = std::numeric_limits<double>::infinity();
+	double allocs_per_op = 0;
+	double bytes_copied_per_op = 0;
+};
+
+constexpr auto mode_name() -> const char*
+{
+#if defined(BT_COPY_BUFFERS)
+	return "copy";
+#else
+	return "steal";
+#endif
+}
+
+constexpr auto stdlib_name() -> const char*
+{
+#if defined(_LIBCPP_VERSION)
+	return "libc++";
+#elif defined(__GLIBCXX__)
+	return "libstdc++";
+#elif defined(_MSC_VER)
+	return "MSVC STL";
+#else
+	return "unknown";
+#endif
+}
+
+template<typename T>
+constexpr auto type_name() -> const char*
+{
+	if constexpr (std::is_same_v<T, char>) { return "char"; }
+	else if constexpr (std::is_same_v<T, wchar_t>) { return "wchar_t"; }
+#if defined(__cpp_lib_char8_t)
+	else if constexpr (std::is_same_v<T, char8_t>) { return "char8_t"; }
+#endif
+	else if constexpr (std::is_same_v<T, char16_t>) { return "char16_t"; }
+	else if constexpr (std::is_same_v<T, char32_t>) { return "char32_t"; }
+	else { return "?"; }
+}
+
+template<typename Container>
+auto generate(std::size_t length) -> Container
+{
+	using T = typename Container::value_type;
+
+	Container ret;
+	ret.reserve(length);
+	for (std::size_t i = 0; i < length; ++i) {
+		ret.push_back(static_cast<T>('a' + i % 26));
+	}
+	return ret;
+}
+
+/**
+ * @brief Times `op` over a batch of freshly generated inputs of the given length.
+ *
+ * Only `op` itself is timed and counted. An operation is considered to have copied
+ * its input when the returned buffer is not the input's original buffer.
+ */
+template<typename Container, typename Op>
+auto measure(std::size_t length, std::size_t copy_bytes, Op op) -> Result
+{
+	using T = typename Container::value_type;
+	using Output = decltype(op(std::declval<Container&>()));
+
+	const std::size_t input_bytes = std::max<std::size_t>(length * sizeof(T), 1);
+	const std::size_t batch = std::clamp<std::size_t>(batch_bytes / input_bytes, 1, max_batch_size);
+
+	Result result;
+	for (int round = 0; round < rounds; ++round) {
+		std::vector<Container> inputs;
+		std::vector<const T*> originals;
+		std::vector<Output> outputs;
+		inputs.reserve(batch);
+		originals.reserve(batch);
+		outputs.reserve(batch);
+
+		for (std::size_t i = 0; i < batch; ++i) {
+			inputs.push_back(generate<Container>(length));
+			originals.push_back(inputs.back().data());
+		}
+
+		const auto allocations_before = allocations_;
+		const auto start = std::chrono::steady_clock::now();
+
+		for (auto& input : inputs) {
+			outputs.push_back(op(input));
+		}
+
+		const auto stop = std::chrono::steady_clock::now();
+		const auto allocations = allocations_ - allocations_before;
+
+		std::size_t bytes_copied = 0;
+		for (std::size_t i = 0; i < batch; ++i) {
+			if (outputs[i] && outputs[i].get() != originals[i]) {
+				bytes_copied += copy_bytes;
+			}
+		}
+
+		const auto ns = std::chrono::duration<double, std::nano>(stop - start).count();
+		result.ns_per_op = std::min(result.ns_per_op, ns / batch);
+		result.allocs_per_op = static_cast<double>(allocations) / batch;
+		result.bytes_copied_per_op = static_cast<double>(bytes_copied) / batch;
+	}
+
+	return result;
+}
+
+void print_header()
+{
+	std::printf("BufferThief benchmark (mode: %s, standard library: %s)\n\n", mode_name(), stdlib_name());
+	std::printf("%-28s %-9s %12s %14s %10s %16s\n",
+		"workload", "type", "size", "ns/op", "allocs/op", "bytes copied/op");
+}
+
+void print_row(const char* workload, const char* type, std::size_t size, const Result& result)
+{
+	std::printf("%-28s %-9s %12zu %14.1f %10.2f %16.0f\n",
+		workload, type, size, result.ns_per_op, result.allocs_per_op, result.bytes_copied_per_op);
+}
+
+template<typename CharT>
+void run_string_workloads()
+{
+	using String = std::basic_string<CharT>;
+
+	for (const auto size : sizes) {
+		const auto copy_bytes = (size + 1) * sizeof(CharT);
+
+		const auto steal = measure<String>(size, copy_bytes, [](String& input) {
+			return bt::steal(std::move(input));
+		});
+		print_row("steal(basic_string&&)", type_name<CharT>(), size, steal);
+
+		const auto try_steal = measure<String>(size, copy_bytes, [](String& input) {
+			return bt::try_steal(input);
+		});
+		print_row("try_steal(basic_string&)", type_name<CharT>(), size, try_steal);
+
+#if !defined(BT_COPY_BUFFERS)
+		const auto slab = measure<String>(size, copy_bytes, [](String& input) {
+			return bt::steal(std::move(input), bt::use_slab);
+		});
+		print_row("steal(basic_string&&, slab)", type_name<CharT>(), size, slab);
+#endif
+	}
+}
+
+template<typename T>
+void run_vector_workloads()
+{
+#if BENCH_VECTORS
+	using Vector = std::vector<T>;
+
+	for (const auto size : sizes) {
+		const auto result = measure<Vector>(size, size * sizeof(T), [](Vector& input) {
+			return bt::steal(std::move(input));
+		});
+		print_row("steal(vector&&)", type_name<T>(), size, result);
+	}
+#endif
+}
+
+template<typename CharT>
+void run_workloads()
+{
+	run_string_workloads<CharT>();
+	run_vector_workloads<CharT>();
+}
+
+} // namespace
+
+void* operator new(std::size_t n) noexcept(false)
+{
+	void* p = std::malloc(n ? n : 1);
+	if (!p) { throw std::bad_alloc{}; }
+	++allocations_;
+	return p;
+}
+
+void* operator new[](std::size_t n) noexcept(false)
+{
+	return ::operator new(n);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+auto main() -> int
+{
+	print_header();
+
+	run_workloads<char>();
+	run_workloads<wchar_t>();
+#if defined(__cpp_lib_char8_t)
+	run_workloads<char8_t>();
+#endif
+	run_workloads<char16_t>();
+	run_workloads<char32_t>();
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * adaptors.hh - Utility for stealing the underlying storage of container adaptors
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_ADAPTORS_H
+#define BUFFER_THIEF_ADAPTORS_H
+
+#include "deque.hh"
+#include "string.hh"
+#include "vector.hh"
+
+#include <queue>
+#include <stack>
+#include <utility>
+
+namespace bt {
+
+namespace detail {
+
+/**
+ * The underlying container of each adaptor is the protected member `c`. A derived
+ * class may form a pointer to it, which is usable with any adaptor of that type,
+ * so the derived class is never instantiated as an object.
+ */
+template<typename Adaptor>
+struct AdaptorAccess : Adaptor
+{
+	static auto container(Adaptor& input) noexcept -> typename Adaptor::container_type&
+	{
+		return input.*(&AdaptorAccess::c);
+	}
+};
+
+template<typename Adaptor>
+inline auto container(Adaptor& input) noexcept -> typename Adaptor::container_type&
+{
+	return AdaptorAccess<Adaptor>::container(input);
+}
+
+} // namespace detail
+
+/**
+ * @returns internal buffer of the stack's container, with the top of the stack last
+ *
+ * Available when the container can be stolen, such as std::vector.
+ */
+template<typename T, typename Container>
+auto steal(std::stack<T, Container>&& input)
+	noexcept(noexcept(bt::steal(std::move(detail::container(input)))))
+	-> decltype(bt::steal(std::move(detail::container(input))))
+{
+	return bt::steal(std::move(detail::container(input)));
+}
+
+/**
+ * @returns internal buffer of the priority queue's container, in heap order
+ *
+ * The largest element according to the comparator is first. The rest are not sorted, but
+ * may be sorted with std::sort_heap or rebuilt into a priority queue with std::push_heap.
+ */
+template<typename T, typename Container, typename Compare>
+auto steal(std::priority_queue<T, Container, Compare>&& input)
+	noexcept(noexcept(bt::steal(std::move(detail::container(input)))))
+	-> decltype(bt::steal(std::move(detail::container(input))))
+{
+	return bt::steal(std::move(detail::container(input)));
+}
+
+//! @returns blocks of the stack's deque as a list of segments, with the top of the stack last
+template<typename T, typename Alloc>
+auto steal_segments(std::stack<T, std::deque<T, Alloc>>&& input) -> segment_list<T, Alloc>
+{
+	return bt::steal_segments(std::move(detail::container(input)));
+}
+
+//! @returns blocks of the queue's deque as a list of segments, with the front of the queue first
+template<typename T, typename Alloc>
+auto steal_segments(std::queue<T, std::deque<T, Alloc>>&& input) -> segment_list<T, Alloc>
+{
+	return bt::steal_segments(std::move(detail::container(input)));
+}
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_ADAPTORS_H
@@ -0,0 +1,290 @@
+/*
+ * arrow.hh - Utility for exporting vectors through the Arrow C Data Interface
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_ARROW_H
+#define BUFFER_THIEF_ARROW_H
+
+#include "string.hh"
+#include "vector.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// ABI-stable definitions from https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+	// Array type description
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowSchema*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+struct ArrowArray
+{
+	// Array data description
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowArray*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace bt {
+
+namespace detail {
+
+//! @returns Arrow format string for a primitive element type, or nullptr if there is none
+template<typename T>
+constexpr auto arrow_format() noexcept -> const char*
+{
+	if constexpr (std::is_same_v<T, std::int8_t>) { return "c"; }
+	else if constexpr (std::is_same_v<T, std::uint8_t>) { return "C"; }
+	else if constexpr (std::is_same_v<T, std::int16_t>) { return "s"; }
+	else if constexpr (std::is_same_v<T, std::uint16_t>) { return "S"; }
+	else if constexpr (std::is_same_v<T, std::int32_t>) { return "i"; }
+	else if constexpr (std::is_same_v<T, std::uint32_t>) { return "I"; }
+	else if constexpr (std::is_same_v<T, std::int64_t>) { return "l"; }
+	else if constexpr (std::is_same_v<T, std::uint64_t>) { return "L"; }
+	else if constexpr (std::is_same_v<T, float>) { return "f"; }
+	else if constexpr (std::is_same_v<T, double>) { return "g"; }
+	else { return nullptr; }
+}
+
+//! Owns the stolen data buffer of an exported primitive array
+template<typename T>
+struct ArrowPrimitiveData
+{
+	T* data;
+	std::size_t capacity;
+	const void* buffers[2];
+};
+
+//! Owns the offsets and data buffers of an exported utf8 array
+struct ArrowStringData
+{
+	std::string* offsets_storage; //!< the vector's buffer, reused for the offsets
+	std::size_t offsets_capacity; //!< in strings
+	char* data;
+	std::size_t data_size;
+	const void* buffers[3];
+};
+
+inline void release_arrow_schema(ArrowSchema* schema) noexcept
+{
+	schema->release = nullptr;
+}
+
+template<typename T>
+void release_arrow_primitive(ArrowArray* array) noexcept
+{
+	auto* data = static_cast<ArrowPrimitiveData<T>*>(array->private_data);
+	if (data->data) {
+		std::allocator<T>{}.deallocate(data->data, data->capacity);
+	}
+	std::allocator<ArrowPrimitiveData<T>>{}.deallocate(data, 1);
+	array->release = nullptr;
+}
+
+inline void release_arrow_string(ArrowArray* array) noexcept
+{
+	auto* data = static_cast<ArrowStringData*>(array->private_data);
+	if (data->offsets_storage) {
+		std::allocator<std::string>{}.deallocate(data->offsets_storage, data->offsets_capacity);
+	}
+	if (data->data) {
+		std::allocator<char>{}.deallocate(data->data, data->data_size);
+	}
+	std::allocator<ArrowStringData>{}.deallocate(data, 1);
+	array->release = nullptr;
+}
+
+inline void export_arrow_schema(ArrowSchema* schema, const char* format) noexcept
+{
+	*schema = ArrowSchema{};
+	schema->format = format;
+	schema->name = "";
+	schema->release = &release_arrow_schema;
+}
+
+} // namespace detail
+
+/**
+ * @brief Exports the vector as an Arrow array without copying its contents.
+ *
+ * The vector's buffer is stolen and freed by the array's release callback. The array has
+ * no validity bitmap. `array` and `schema` are overwritten and must be released by the consumer.
+ */
+template<typename T>
+void to_arrow(std::vector<T>&& input, ArrowArray* array, ArrowSchema* schema)
+{
+	static_assert(detail::arrow_format<T>() != nullptr, "Element type has no Arrow primitive format");
+
+	auto* data = std::allocator<detail::ArrowPrimitiveData<T>>{}.allocate(1);
+
+	const auto length = static_cast<std::int64_t>(input.size());
+	auto stolen = bt::steal(std::move(input));
+
+	data->capacity = stolen.capacity();
+	data->data = stolen.release();
+	data->buffers[0] = nullptr;
+	data->buffers[1] = data->data;
+
+	*array = ArrowArray{};
+	array->length = length;
+	array->n_buffers = 2;
+	array->buffers = data->buffers;
+	array->release = &detail::release_arrow_primitive<T>;
+	array->private_data = data;
+
+	detail::export_arrow_schema(schema, detail::arrow_format<T>());
+}
+
+/**
+ * @brief Exports the strings as an Arrow utf8 array, or large_utf8 if they exceed 2 GiB in total.
+ *
+ * The characters are copied into a single data buffer, while the offsets reuse the vector's
+ * buffer. The vector is left empty with no buffer. If an exception is thrown, it is unchanged.
+ * `array` and `schema` are overwritten and must be released by the consumer.
+ */
+inline void to_arrow(std::vector<std::string>&& input, ArrowArray* array, ArrowSchema* schema)
+{
+	static_assert(sizeof(std::string) >= sizeof(std::int64_t), "The offsets must fit in the vector's buffer");
+
+	const auto size = input.size();
+
+	std::size_t data_size = 0;
+	for (const auto& str : input) {
+		data_size += str.size();
+	}
+	const bool large = data_size > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+	// Allocate everything before taking ownership of the strings
+	auto* data = std::allocator<detail::ArrowStringData>{}.allocate(1);
+	data->data = nullptr;
+	data->data_size = data_size;
+	data->offsets_storage = nullptr;
+	data->offsets_capacity = 0;
+
+	try {
+		if (data_size > 0) {
+			data->data = std::allocator<char>{}.allocate(data_size);
+		}
+#if defined(BT_COPY_BUFFERS)
+		data->offsets_capacity = size + 1;
+#else
+		if (input.capacity() == 0) { data->offsets_capacity = 1; }
+#endif
+		if (data->offsets_capacity > 0) {
+			data->offsets_storage = std::allocator<std::string>{}.allocate(data->offsets_capacity);
+		}
+	} catch (...) {
+		if (data->data) { std::allocator<char>{}.deallocate(data->data, data_size); }
+		std::allocator<detail::ArrowStringData>{}.deallocate(data, 1);
+		throw;
+	}
+
+	std::string* strings = input.data();
+#if !defined(BT_COPY_BUFFERS)
+	if (!data->offsets_storage) {
+		auto outer = bt::steal(std::move(input));
+		data->offsets_capacity = outer.capacity();
+		strings = outer.release();
+		data->offsets_storage = strings;
+	}
+#endif
+
+	auto* storage = reinterpret_cast<unsigned char*>(data->offsets_storage);
+	const auto write_offset = [storage, large](std::size_t index, std::size_t value) {
+		if (large) {
+			const auto offset = static_cast<std::int64_t>(value);
+			std::memcpy(storage + index * sizeof(offset), &offset, sizeof(offset));
+		} else {
+			const auto offset = static_cast<std::int32_t>(value);
+			std::memcpy(storage + index * sizeof(offset), &offset, sizeof(offset));
+		}
+	};
+
+	std::size_t position = 0;
+	for (std::size_t i = 0; i < size; ++i) {
+		std::string& str = strings[i];
+		if (!str.empty()) {
+			std::memcpy(data->data + position, str.data(), str.size());
+		}
+		position += str.size();
+
+#if !defined(BT_COPY_BUFFERS)
+		if (strings == data->offsets_storage) {
+			str.~basic_string();
+		}
+#endif
+
+		// Offsets are smaller than strings, so this only overwrites strings which were already destroyed
+		if (i == 0) { write_offset(0, 0); }
+		write_offset(i + 1, position);
+	}
+	if (size == 0) { write_offset(0, 0); }
+
+	if (strings != data->offsets_storage) {
+		std::vector<std::string>{}.swap(input);
+	}
+
+	data->buffers[0] = nullptr;
+	data->buffers[1] = data->offsets_storage;
+	data->buffers[2] = data->data;
+
+	*array = ArrowArray{};
+	array->length = static_cast<std::int64_t>(size);
+	array->n_buffers = 3;
+	array->buffers = data->buffers;
+	array->release = &detail::release_arrow_string;
+	array->private_data = data;
+
+	detail::export_arrow_schema(schema, large ? "U" : "u");
+}
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_ARROW_H
@@ -0,0 +1,129 @@
+/*
+ * bit_vector.hh - Utility for stealing the packed words of std::vector<bool>
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_BIT_VECTOR_H
+#define BUFFER_THIEF_BIT_VECTOR_H
+
+#include "buffer.hh"
+#include "private/common_vector.hh"
+
+#undef BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
+#if !defined(BT_COPY_BUFFERS)
+#	include "private/bit_vector_libc++.hh"
+#	include "private/bit_vector_libstdc++.hh"
+#	if !defined(BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED)
+#		error "No supported C++ Standard Library implementation detected"
+#	endif
+#endif
+
+#include <climits>
+#include <cstddef>
+#include <memory>
+
+namespace bt {
+
+namespace detail {
+
+#if defined(BT_COPY_BUFFERS)
+using BitWord = std::size_t;
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Bits of a std::vector<bool>, packed into words.
+ *
+ * Bit `i` is bit `i % bits_per_word` of word `i / bits_per_word`, counting from the least
+ * significant bit. Bits past size() in the last word have unspecified values.
+ */
+template<typename Allocator = std::allocator<bool>>
+struct bit_buffer
+{
+	using word_type = detail::BitWord;
+	using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<word_type>;
+
+	static constexpr std::size_t bits_per_word = sizeof(word_type) * CHAR_BIT;
+
+	//! Packed words. The buffer's size is the number of words holding bits.
+	buffer<word_type, word_allocator> words;
+
+	//! Number of bits
+	std::size_t bits = 0;
+
+	auto size() const noexcept -> std::size_t { return bits; }
+
+	auto empty() const noexcept -> bool { return bits == 0; }
+
+	auto test(std::size_t index) const noexcept -> bool
+	{
+		return (words[index / bits_per_word] >> (index % bits_per_word)) & 1;
+	}
+};
+
+#if defined(BT_COPY_BUFFERS)
+#define BT_NOEXCEPT
+#else
+#define BT_NOEXCEPT noexcept
+#endif
+
+/**
+ * @returns packed words of the vector, or an empty buffer if it has none
+ *
+ * The words are deallocated with the vector's allocator, rebound to the word type.
+ * The vector is left empty.
+ */
+template<typename Alloc>
+auto steal_bits(std::vector<bool, Alloc>&& input) BT_NOEXCEPT -> bit_buffer<Alloc>
+{
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+
+	using Result = bit_buffer<Alloc>;
+	using WordAlloc = typename Result::word_allocator;
+
+	const auto bits = input.size();
+	const auto word_count = (bits + Result::bits_per_word - 1) / Result::bits_per_word;
+	WordAlloc alloc{input.get_allocator()};
+
+#if !defined(BT_COPY_BUFFERS)
+	std::size_t capacity = 0;
+	auto* words = detail::steal_bits(input, capacity);
+	if (!words) { return Result{buffer<detail::BitWord, WordAlloc>{alloc}, 0}; }
+
+	return Result{buffer<detail::BitWord, WordAlloc>{words, word_count, capacity, alloc}, bits};
+#else
+	Result result{buffer<detail::BitWord, WordAlloc>{alloc}, bits};
+	if (word_count == 0) { return result; }
+
+	result.words = buffer<detail::BitWord, WordAlloc>{std::allocator_traits<WordAlloc>::allocate(alloc, word_count),
+		0, word_count, alloc};
+	for (std::size_t i = 0; i < word_count; ++i) {
+		result.words.emplace_back(0);
+	}
+	for (std::size_t i = 0; i < bits; ++i) {
+		if (input[i]) {
+			result.words[i / Result::bits_per_word] |= detail::BitWord{1} << (i % Result::bits_per_word);
+		}
+	}
+
+	input = std::vector<bool, Alloc>{input.get_allocator()};
+	return result;
+#endif
+}
+
+#undef BT_NOEXCEPT
+
+} // namespace bt
+
+#undef BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
+
+#endif // BUFFER_THIEF_BIT_VECTOR_H
@@ -0,0 +1,217 @@
+/*
+ * buffer.hh - Owning buffer type returned when stealing
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_BUFFER_H
+#define BUFFER_THIEF_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if (__cpp_constexpr_dynamic_alloc >= 201907L)
+#	define BT_BUFFER_CONSTEXPR20 constexpr
+#else
+#	define BT_BUFFER_CONSTEXPR20 inline
+#endif
+
+namespace bt {
+
+/**
+ * @brief Owning buffer of elements allocated by `Allocator`, such as one stolen from a container.
+ *
+ * Remembers its size and capacity, so it is released with the allocator's sized deallocate().
+ * The first size() elements are constructed and are destroyed along with the buffer. The rest
+ * of the capacity is uninitialized and may be appended to in place.
+ *
+ * Buffers stolen from strings also hold a null terminator at data()[size()], which is
+ * included in capacity() but not in size().
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class buffer
+{
+	static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::pointer, T*>,
+		"Allocators with fancy pointers are not supported");
+
+	using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+	using value_type = T;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	BT_BUFFER_CONSTEXPR20 buffer() = default;
+
+	BT_BUFFER_CONSTEXPR20 buffer(std::nullptr_t) noexcept(noexcept(Allocator())) {}
+
+	BT_BUFFER_CONSTEXPR20 explicit buffer(const Allocator& alloc) noexcept
+		: storage_{alloc}
+	{}
+
+	/**
+	 * @brief Takes ownership of `data`.
+	 *
+	 * `data` must have been allocated by `alloc` with room for `capacity` elements,
+	 * the first `size` of which are constructed.
+	 */
+	BT_BUFFER_CONSTEXPR20 buffer(T* data, size_type size, size_type capacity,
+		const Allocator& alloc = Allocator()) noexcept
+		: storage_{alloc, data, size, capacity}
+	{}
+
+	BT_BUFFER_CONSTEXPR20 buffer(buffer&& other) noexcept
+		: storage_{std::move(other.storage_)}
+	{
+		other.forget();
+	}
+
+	BT_BUFFER_CONSTEXPR20 auto operator=(buffer&& other) noexcept -> buffer&
+	{
+		if (this != &other) {
+			reset();
+			if constexpr (std::is_move_assignable_v<Allocator>) {
+				storage_ = std::move(other.storage_);
+			} else {
+				// For example, std::pmr::polymorphic_allocator
+				storage_.~Storage();
+				::new (static_cast<void*>(std::addressof(storage_))) Storage{std::move(other.storage_)};
+			}
+			other.forget();
+		}
+		return *this;
+	}
+
+	buffer(const buffer&) = delete;
+	auto operator=(const buffer&) -> buffer& = delete;
+
+	BT_BUFFER_CONSTEXPR20 ~buffer()
+	{
+		reset();
+	}
+
+	BT_BUFFER_CONSTEXPR20 auto data() noexcept -> T* { return storage_.data; }
+	BT_BUFFER_CONSTEXPR20 auto data() const noexcept -> const T* { return storage_.data; }
+
+	//! Same as data(), for familiarity with std::unique_ptr
+	BT_BUFFER_CONSTEXPR20 auto get() const noexcept -> T* { return storage_.data; }
+
+	//! Number of constructed elements
+	BT_BUFFER_CONSTEXPR20 auto size() const noexcept -> size_type { return storage_.size; }
+
+	//! Number of allocated elements
+	BT_BUFFER_CONSTEXPR20 auto capacity() const noexcept -> size_type { return storage_.capacity; }
+
+	//! Number of elements which may be constructed past the end without reallocating
+	BT_BUFFER_CONSTEXPR20 auto spare_capacity() const noexcept -> size_type
+	{
+		return storage_.capacity - storage_.size;
+	}
+
+	BT_BUFFER_CONSTEXPR20 auto empty() const noexcept -> bool { return storage_.size == 0; }
+
+	BT_BUFFER_CONSTEXPR20 auto begin() noexcept -> iterator { return storage_.data; }
+	BT_BUFFER_CONSTEXPR20 auto begin() const noexcept -> const_iterator { return storage_.data; }
+	BT_BUFFER_CONSTEXPR20 auto end() noexcept -> iterator { return storage_.data + storage_.size; }
+	BT_BUFFER_CONSTEXPR20 auto end() const noexcept -> const_iterator { return storage_.data + storage_.size; }
+
+	BT_BUFFER_CONSTEXPR20 auto operator[](size_type index) noexcept -> T& { return storage_.data[index]; }
+	BT_BUFFER_CONSTEXPR20 auto operator[](size_type index) const noexcept -> const T& { return storage_.data[index]; }
+
+	//! Whether the buffer owns an allocation
+	BT_BUFFER_CONSTEXPR20 explicit operator bool() const noexcept { return storage_.data != nullptr; }
+
+	BT_BUFFER_CONSTEXPR20 auto get_allocator() const noexcept -> Allocator { return storage_; }
+
+	/**
+	 * @brief Constructs an element in place at end(). Requires spare_capacity() > 0.
+	 */
+	template<typename... Args>
+	BT_BUFFER_CONSTEXPR20 auto emplace_back(Args&&... args) -> T&
+	{
+		T* p = storage_.data + storage_.size;
+		AllocTraits::construct(storage_, p, std::forward<Args>(args)...);
+		++storage_.size;
+		return *p;
+	}
+
+	/**
+	 * @brief Adds `count` elements which were constructed in place at end() to the buffer.
+	 * Requires `count <= spare_capacity()`.
+	 */
+	BT_BUFFER_CONSTEXPR20 void commit(size_type count) noexcept
+	{
+		storage_.size += count;
+	}
+
+	/**
+	 * @brief Releases ownership of the allocation without destroying any elements.
+	 *
+	 * The caller becomes responsible for destroying the first size() elements and for
+	 * deallocating capacity() elements with the allocator.
+	 */
+	BT_BUFFER_CONSTEXPR20 auto release() noexcept -> T*
+	{
+		T* ptr = storage_.data;
+		forget();
+		return ptr;
+	}
+
+	//! Destroys the elements and deallocates the buffer
+	BT_BUFFER_CONSTEXPR20 void reset() noexcept
+	{
+		if (!storage_.data) { return; }
+
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (size_type i = 0; i < storage_.size; ++i) {
+				AllocTraits::destroy(storage_, storage_.data + i);
+			}
+		}
+
+		AllocTraits::deallocate(storage_, storage_.data, storage_.capacity);
+		forget();
+	}
+
+	friend BT_BUFFER_CONSTEXPR20 auto operator==(const buffer& lhs, std::nullptr_t) noexcept -> bool { return !lhs; }
+	friend BT_BUFFER_CONSTEXPR20 auto operator==(std::nullptr_t, const buffer& rhs) noexcept -> bool { return !rhs; }
+	friend BT_BUFFER_CONSTEXPR20 auto operator!=(const buffer& lhs, std::nullptr_t) noexcept -> bool { return !!lhs; }
+	friend BT_BUFFER_CONSTEXPR20 auto operator!=(std::nullptr_t, const buffer& rhs) noexcept -> bool { return !!rhs; }
+
+private:
+	BT_BUFFER_CONSTEXPR20 void forget() noexcept
+	{
+		storage_.data = nullptr;
+		storage_.size = 0;
+		storage_.capacity = 0;
+	}
+
+	//! Derives from the allocator to take advantage of the empty base optimization
+	struct Storage : Allocator
+	{
+		T* data = nullptr;
+		size_type size = 0;
+		size_type capacity = 0;
+	};
+
+	Storage storage_;
+};
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_BUFFER_H
@@ -0,0 +1,291 @@
+/*
+ * buffer_pool.hh - Recycles stolen buffers into new strings and vectors
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_BUFFER_POOL_H
+#define BUFFER_THIEF_BUFFER_POOL_H
+
+#include "buffer.hh"
+#include "string.hh"
+#include "vector.hh"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace bt {
+
+namespace detail {
+
+//! An allocation of `bytes` bytes made by std::allocator
+struct PoolBlock
+{
+	void* ptr = nullptr;
+	std::size_t bytes = 0;
+};
+
+template<std::size_t N>
+struct PoolBin
+{
+	std::array<PoolBlock, N> blocks;
+	std::size_t count = 0;
+
+	auto push(PoolBlock block) noexcept -> bool
+	{
+		if (count == N) { return false; }
+		blocks[count++] = block;
+		return true;
+	}
+
+	//! Takes the most recently pushed block with at least `min_bytes` which holds whole elements
+	auto take(std::size_t min_bytes, std::size_t element_size, PoolBlock& out) noexcept -> bool
+	{
+		for (std::size_t i = count; i-- > 0;) {
+			if (blocks[i].bytes >= min_bytes && blocks[i].bytes % element_size == 0) {
+				out = blocks[i];
+				blocks[i] = blocks[--count];
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+constexpr auto floor_log2(std::size_t value) noexcept -> std::size_t
+{
+	std::size_t result = 0;
+	while (value >>= 1) { ++result; }
+	return result;
+}
+
+constexpr auto ceil_log2(std::size_t value) noexcept -> std::size_t
+{
+	return value <= 1 ? 0 : floor_log2(value - 1) + 1;
+}
+
+inline void free_block(PoolBlock block) noexcept
+{
+	std::allocator<std::byte>{}.deallocate(static_cast<std::byte*>(block.ptr), block.bytes);
+}
+
+} // namespace detail
+
+/**
+ * @brief Process-wide pool of buffers, keyed by capacity class.
+ *
+ * Stolen buffers which are no longer needed can be recycled into the pool, and new strings and
+ * vectors can then be created with pooled storage without copying or allocating. Each thread has
+ * its own cache, backed by a shared overflow list, so in steady state a thread which recycles as
+ * many buffers as it creates does not touch the allocator or take a lock.
+ *
+ * Storage from the pool is allocated by std::allocator, so the containers and buffers it seeds
+ * need no special handling and may be freed normally.
+ */
+class buffer_pool
+{
+public:
+	//! Buffers smaller than this many bytes are not pooled
+	static constexpr std::size_t min_block_size = std::size_t{1} << 6;
+
+	//! Buffers larger than this many bytes are not pooled
+	static constexpr std::size_t max_block_size = std::size_t{1} << 27;
+
+	//! Maximum number of buffers per capacity class in each thread's cache
+	static constexpr std::size_t thread_cache_size = 8;
+
+	//! Maximum number of buffers per capacity class in the shared overflow list
+	static constexpr std::size_t shared_cache_size = 64;
+
+	static auto instance() -> buffer_pool&
+	{
+		// Never destroyed, since thread caches may be flushed into it during program exit
+		static buffer_pool* const pool = new buffer_pool;
+		return *pool;
+	}
+
+	buffer_pool(const buffer_pool&) = delete;
+	auto operator=(const buffer_pool&) -> buffer_pool& = delete;
+
+	//! Destroys the buffer's elements and returns its storage to the pool
+	template<typename T>
+	void recycle(buffer<T>&& input) noexcept
+	{
+		static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Over-aligned types are not supported");
+
+		const auto size = input.size();
+		const auto capacity = input.capacity();
+		T* ptr = input.release();
+		if (!ptr) { return; }
+
+		std::destroy_n(ptr, size);
+		recycle(detail::PoolBlock{ptr, capacity * sizeof(T)});
+	}
+
+	//! @returns empty string with a capacity of at least `capacity`, using pooled storage when possible
+	template<typename CharT>
+	auto make_string(std::size_t capacity) -> std::basic_string<CharT>
+	{
+#if !defined(BT_COPY_BUFFERS)
+		if (capacity > detail::small_string_max_size<CharT>()) {
+			// Includes the null terminator
+			const auto block = acquire((capacity + 1) * sizeof(CharT), sizeof(CharT));
+			auto output = bt::adopt(buffer<CharT>{static_cast<CharT*>(block.ptr), 0, block.bytes / sizeof(CharT)});
+
+			// Adoption falls back to a copy when the library cannot represent the block's capacity
+			if (output.capacity() < capacity) { output.reserve(capacity); }
+			return output;
+		}
+#endif
+
+		std::basic_string<CharT> output;
+		output.reserve(capacity);
+		return output;
+	}
+
+	//! @returns empty vector with a capacity of at least `capacity`, using pooled storage when possible
+	template<typename T>
+	auto make_vector(std::size_t capacity) -> std::vector<T>
+	{
+		static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Over-aligned types are not supported");
+
+#if !defined(BT_COPY_BUFFERS)
+		if (capacity > 0) {
+			const auto block = acquire(capacity * sizeof(T), sizeof(T));
+			return bt::adopt_vector(buffer<T>{static_cast<T*>(block.ptr), 0, block.bytes / sizeof(T)});
+		}
+#endif
+
+		std::vector<T> output;
+		output.reserve(capacity);
+		return output;
+	}
+
+	//! Frees the buffers in the calling thread's cache and in the shared overflow list
+	void trim() noexcept
+	{
+		thread_cache().clear();
+
+		std::lock_guard lock{mutex_};
+		for (auto& bin : shared_) {
+			while (bin.count > 0) {
+				detail::free_block(bin.blocks[--bin.count]);
+			}
+		}
+	}
+
+private:
+	static constexpr std::size_t min_class = detail::floor_log2(min_block_size);
+	static constexpr std::size_t max_class = detail::floor_log2(max_block_size);
+	static constexpr std::size_t class_count = max_class - min_class + 1;
+
+	struct ThreadCache
+	{
+		std::array<detail::PoolBin<thread_cache_size>, class_count> bins;
+
+		~ThreadCache()
+		{
+			auto& pool = buffer_pool::instance();
+			for (auto& bin : bins) {
+				while (bin.count > 0) {
+					pool.recycle_shared(bin.blocks[--bin.count]);
+				}
+			}
+		}
+
+		void clear() noexcept
+		{
+			for (auto& bin : bins) {
+				while (bin.count > 0) {
+					detail::free_block(bin.blocks[--bin.count]);
+				}
+			}
+		}
+	};
+
+	buffer_pool() = default;
+
+	static auto thread_cache() -> ThreadCache&
+	{
+		static thread_local ThreadCache cache;
+		return cache;
+	}
+
+	void recycle(detail::PoolBlock block) noexcept
+	{
+		const auto size_class = detail::floor_log2(block.bytes);
+		if (block.bytes < min_block_size || size_class > max_class) {
+			detail::free_block(block);
+			return;
+		}
+
+		if (!thread_cache().bins[size_class - min_class].push(block)) {
+			recycle_shared(block);
+		}
+	}
+
+	void recycle_shared(detail::PoolBlock block) noexcept
+	{
+		std::lock_guard lock{mutex_};
+		if (!shared_[detail::floor_log2(block.bytes) - min_class].push(block)) {
+			detail::free_block(block);
+		}
+	}
+
+	/**
+	 * @returns block of at least `min_bytes` which holds a whole number of elements
+	 *
+	 * A block in class k holds [2^k, 2^(k + 1)) bytes, so only the class below the smallest
+	 * class which is guaranteed to fit and the class above it need to be searched.
+	 */
+	auto acquire(std::size_t min_bytes, std::size_t element_size) -> detail::PoolBlock
+	{
+		const auto fit_class = detail::ceil_log2(min_bytes);
+		if (fit_class <= max_class) {
+			const auto first = fit_class > min_class ? fit_class - 1 : min_class;
+			const auto last = fit_class < max_class ? fit_class + 1 : max_class;
+
+			detail::PoolBlock block;
+			auto& cache = thread_cache();
+			for (auto k = first; k <= last; ++k) {
+				if (cache.bins[k - min_class].take(min_bytes, element_size, block)) {
+					return block;
+				}
+			}
+
+			std::lock_guard lock{mutex_};
+			for (auto k = first; k <= last; ++k) {
+				if (shared_[k - min_class].take(min_bytes, element_size, block)) {
+					return block;
+				}
+			}
+		}
+
+		// Allocate a new block, rounding up so it can be reused for more sizes later
+		auto bytes = fit_class <= max_class
+			? std::size_t{1} << (fit_class > min_class ? fit_class : min_class)
+			: min_bytes;
+
+		// The container deallocates whole elements, so the block must hold a whole number of them.
+		// `min_bytes` is a multiple of `element_size`, so this never drops below it.
+		bytes -= bytes % element_size;
+
+		return detail::PoolBlock{std::allocator<std::byte>{}.allocate(bytes), bytes};
+	}
+
+	std::mutex mutex_;
+	std::array<detail::PoolBin<shared_cache_size>, class_count> shared_;
+};
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_BUFFER_POOL_H
@@ -0,0 +1,157 @@
+/*
+ * buffer_queue.hh - Bounded lock-free queue for handing stolen buffers to another thread
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_BUFFER_QUEUE_H
+#define BUFFER_THIEF_BUFFER_QUEUE_H
+
+#include "buffer.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace bt {
+
+/**
+ * @brief Bounded queue of buffers with any number of producers and a single consumer.
+ *
+ * A ring of slots, each with a sequence number which says whether it is ready to be written
+ * or read, so neither side takes a lock. Producers claim a slot with a compare-and-swap on
+ * the tail, which SingleProducer replaces with a plain store. The consumer owns the head.
+ *
+ * Buffers are moved in and out, so their contents are never copied.
+ */
+template<typename T, typename Allocator = std::allocator<T>, bool SingleProducer = false>
+class buffer_queue
+{
+public:
+	using value_type = buffer<T, Allocator>;
+	using size_type = std::size_t;
+
+	//! The capacity is rounded up to a power of two, and is at least 2
+	explicit buffer_queue(size_type capacity)
+		: slots_{new Slot[round_capacity(capacity)]}
+		, mask_{round_capacity(capacity) - 1}
+	{
+		for (size_type i = 0; i <= mask_; ++i) {
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	buffer_queue(const buffer_queue&) = delete;
+	auto operator=(const buffer_queue&) -> buffer_queue& = delete;
+
+	//! Destroys any buffers still in the queue. No other thread may be using it.
+	~buffer_queue()
+	{
+		value_type discarded;
+		while (try_pop(discarded)) {}
+	}
+
+	auto capacity() const noexcept -> size_type { return mask_ + 1; }
+
+	/**
+	 * @brief Moves `item` into the queue. May be called from any thread unless SingleProducer is set.
+	 * @returns false and leaves `item` unchanged if the queue is full
+	 */
+	auto try_push(value_type&& item) noexcept -> bool
+	{
+		size_type pos = tail_.load(std::memory_order_relaxed);
+		Slot* slot;
+
+		if constexpr (SingleProducer) {
+			slot = &slots_[pos & mask_];
+			if (slot->sequence.load(std::memory_order_acquire) != pos) { return false; }
+			tail_.store(pos + 1, std::memory_order_relaxed);
+		} else {
+			for (;;) {
+				slot = &slots_[pos & mask_];
+				const auto sequence = slot->sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+				if (diff == 0) {
+					if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+				} else if (diff < 0) {
+					// The consumer has not read this slot since the last lap
+					return false;
+				} else {
+					// Another producer claimed the slot
+					pos = tail_.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		::new (static_cast<void*>(slot->storage)) value_type{std::move(item)};
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Moves the oldest buffer into `output`. Must only be called from the consumer thread.
+	 * @returns false if the queue is empty
+	 */
+	auto try_pop(value_type& output) noexcept -> bool
+	{
+		return try_pop(&output, 1) == 1;
+	}
+
+	/**
+	 * @brief Moves up to `max_count` of the oldest buffers into `output`, in order.
+	 * Must only be called from the consumer thread.
+	 * @returns number of buffers moved
+	 */
+	auto try_pop(value_type* output, size_type max_count) noexcept -> size_type
+	{
+		size_type count = 0;
+		for (; count < max_count; ++count, ++head_) {
+			Slot& slot = slots_[head_ & mask_];
+			if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) { break; }
+
+			value_type* item = std::launder(reinterpret_cast<value_type*>(slot.storage));
+			output[count] = std::move(*item);
+			item->~value_type();
+
+			// Ready for the producer one lap ahead
+			slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+		}
+		return count;
+	}
+
+private:
+	static constexpr size_type cache_line_size = 64;
+
+	struct alignas(cache_line_size) Slot
+	{
+		std::atomic<size_type> sequence;
+		alignas(value_type) unsigned char storage[sizeof(value_type)];
+	};
+
+	static auto round_capacity(size_type capacity) noexcept -> size_type
+	{
+		size_type result = 2;
+		while (result < capacity) { result <<= 1; }
+		return result;
+	}
+
+	std::unique_ptr<Slot[]> slots_;
+	size_type mask_;
+
+	alignas(cache_line_size) std::atomic<size_type> tail_{0};
+	alignas(cache_line_size) size_type head_ = 0;
+};
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_BUFFER_QUEUE_H
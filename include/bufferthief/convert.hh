@@ -0,0 +1,99 @@
+/*
+ * convert.hh - Utility for moving a buffer between std::basic_string and std::vector
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_CONVERT_H
+#define BUFFER_THIEF_CONVERT_H
+
+#include "string.hh"
+#include "vector.hh"
+
+#include <memory>
+#include <type_traits>
+
+namespace bt {
+
+namespace detail {
+
+template<typename Alloc, typename T>
+using RebindAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+/**
+ * @brief Reinterprets a buffer's elements as another type with the same size and alignment.
+ *
+ * The allocation is released with the rebound allocator, which deallocates the same number of bytes.
+ */
+template<typename T, typename U, typename Alloc>
+BT_BUFFER_CONSTEXPR20 auto rebind_buffer(buffer<U, Alloc>&& input) noexcept -> buffer<T, RebindAlloc<Alloc, T>>
+{
+	if constexpr (std::is_same_v<T, U>) {
+		return std::move(input);
+	} else {
+		static_assert(sizeof(T) == sizeof(U) && alignof(T) == alignof(U), "Element types must have the same size and alignment");
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<U>, "Element types must be trivially copyable");
+
+		RebindAlloc<Alloc, T> alloc{input.get_allocator()};
+		const auto size = input.size();
+		const auto capacity = input.capacity();
+		return buffer<T, RebindAlloc<Alloc, T>>{reinterpret_cast<T*>(input.release()), size, capacity, alloc};
+	}
+}
+
+//! The element type of the vector produced from a string of `CharT`
+template<typename T, typename CharT>
+using ConvertedElement = std::conditional_t<!std::is_void_v<T>, T, CharT>;
+
+//! The character type of the string produced from a vector of `T`
+template<typename CharT, typename T>
+using ConvertedChar = std::conditional_t<!std::is_void_v<CharT>, CharT,
+	std::conditional_t<SupportedChar<T>::value, T, char>>;
+
+} // namespace detail
+
+/**
+ * @returns vector which owns the string's buffer, or a copy of a small string
+ *
+ * The element type defaults to the string's character type, but may be any trivially copyable
+ * type of the same size and alignment, such as std::byte. The vector's capacity includes the
+ * string's null terminator.
+ */
+template<typename T = void, typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR23 auto to_vector(std::basic_string<CharT, std::char_traits<CharT>, Alloc>&& input)
+	-> std::vector<detail::ConvertedElement<T, CharT>, detail::RebindAlloc<Alloc, detail::ConvertedElement<T, CharT>>>
+{
+	using Element = detail::ConvertedElement<T, CharT>;
+
+	return bt::adopt_vector(detail::rebind_buffer<Element>(bt::steal(std::move(input))));
+}
+
+/**
+ * @returns string which owns the vector's buffer, or a copy if it is small or full
+ *
+ * The character type defaults to the vector's element type if it is a character type, and
+ * to char otherwise (such as for std::byte). The vector needs at least one element of spare
+ * capacity to hold the null terminator, otherwise it is copied. With libc++, the capacity
+ * must also be even.
+ */
+template<typename CharT = void, typename T, typename Alloc>
+BT_STRING_CONSTEXPR23 auto to_string(std::vector<T, Alloc>&& input)
+	-> std::basic_string<detail::ConvertedChar<CharT, T>, std::char_traits<detail::ConvertedChar<CharT, T>>,
+		detail::RebindAlloc<Alloc, detail::ConvertedChar<CharT, T>>>
+{
+	using Char = detail::ConvertedChar<CharT, T>;
+	static_assert(detail::SupportedChar<Char>::value, "Unsupported character type");
+
+	return bt::adopt(detail::rebind_buffer<Char>(bt::steal(std::move(input))));
+}
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_CONVERT_H
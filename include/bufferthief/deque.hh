@@ -0,0 +1,275 @@
+/*
+ * deque.hh - Utility for stealing the blocks of std::deque as a list of segments
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_DEQUE_H
+#define BUFFER_THIEF_DEQUE_H
+
+#include "buffer.hh"
+#include "private/common_deque.hh"
+
+#undef BUFFER_THIEF_DEQUE_IMPLEMENTED
+#if !defined(BT_COPY_BUFFERS)
+#	include "private/deque_libc++.hh"
+#	include "private/deque_libstdc++.hh"
+#	if !defined(BUFFER_THIEF_DEQUE_IMPLEMENTED)
+#		error "No supported C++ Standard Library implementation detected"
+#	endif
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/uio.h>)
+#	include <sys/uio.h>
+#	include <vector>
+#endif
+
+namespace bt {
+
+//! Contiguous run of elements. Arrays of segments may be passed to C as `{T* data; size_t size;}` structs.
+template<typename T>
+struct segment
+{
+	T* data;
+	std::size_t size;
+};
+
+/**
+ * @brief Owning list of segments, such as the blocks stolen from a deque.
+ *
+ * Each segment lies in its own block of block_capacity() elements allocated by `Allocator`.
+ * The first segment may start partway into its block. The elements are destroyed and the
+ * blocks deallocated along with the list.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class segment_list
+{
+	static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::pointer, T*>,
+		"Allocators with fancy pointers are not supported");
+
+	using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+	using value_type = segment<T>;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using const_iterator = const segment<T>*;
+
+	segment_list() = default;
+
+	explicit segment_list(const Allocator& alloc) noexcept
+		: alloc_{alloc}
+	{}
+
+	/**
+	 * @brief Takes ownership of `segments` and the blocks they lie in.
+	 *
+	 * `segments` must have been allocated by std::allocator with room for `count` segments.
+	 * Each block must have been allocated by `alloc` with room for `block_capacity` elements.
+	 * The first segment starts `first_offset` elements into its block, and the rest start at
+	 * the beginning of theirs.
+	 */
+	segment_list(segment<T>* segments, size_type count, size_type first_offset, size_type block_capacity,
+		const Allocator& alloc = Allocator()) noexcept
+		: alloc_{alloc}
+		, segments_{segments}
+		, count_{count}
+		, first_offset_{first_offset}
+		, block_capacity_{block_capacity}
+	{
+		for (size_type i = 0; i < count_; ++i) {
+			total_size_ += segments_[i].size;
+		}
+	}
+
+	segment_list(segment_list&& other) noexcept
+		: alloc_{std::move(other.alloc_)}
+		, segments_{std::exchange(other.segments_, nullptr)}
+		, count_{std::exchange(other.count_, 0)}
+		, first_offset_{std::exchange(other.first_offset_, 0)}
+		, block_capacity_{std::exchange(other.block_capacity_, 0)}
+		, total_size_{std::exchange(other.total_size_, 0)}
+	{}
+
+	auto operator=(segment_list&& other) noexcept -> segment_list&
+	{
+		if (this != &other) {
+			reset();
+			if constexpr (std::is_move_assignable_v<Allocator>) {
+				alloc_ = std::move(other.alloc_);
+			} else {
+				// For example, std::pmr::polymorphic_allocator
+				alloc_.~Allocator();
+				::new (static_cast<void*>(std::addressof(alloc_))) Allocator{std::move(other.alloc_)};
+			}
+			segments_ = std::exchange(other.segments_, nullptr);
+			count_ = std::exchange(other.count_, 0);
+			first_offset_ = std::exchange(other.first_offset_, 0);
+			block_capacity_ = std::exchange(other.block_capacity_, 0);
+			total_size_ = std::exchange(other.total_size_, 0);
+		}
+		return *this;
+	}
+
+	segment_list(const segment_list&) = delete;
+	auto operator=(const segment_list&) -> segment_list& = delete;
+
+	~segment_list()
+	{
+		reset();
+	}
+
+	//! Segments as a C array
+	auto data() const noexcept -> const segment<T>* { return segments_; }
+
+	//! Number of segments
+	auto size() const noexcept -> size_type { return count_; }
+
+	auto empty() const noexcept -> bool { return count_ == 0; }
+
+	//! Number of elements in every segment
+	auto total_size() const noexcept -> size_type { return total_size_; }
+
+	//! Number of elements allocated for each block
+	auto block_capacity() const noexcept -> size_type { return block_capacity_; }
+
+	auto begin() const noexcept -> const_iterator { return segments_; }
+	auto end() const noexcept -> const_iterator { return segments_ + count_; }
+
+	auto operator[](size_type index) const noexcept -> const segment<T>& { return segments_[index]; }
+
+	auto get_allocator() const noexcept -> Allocator { return alloc_; }
+
+#if __has_include(<sys/uio.h>)
+	//! @returns each segment as a byte range for readv/writev, valid while the list owns it
+	auto to_iovecs() const -> std::vector<::iovec>
+	{
+		std::vector<::iovec> output(count_);
+		for (size_type i = 0; i < count_; ++i) {
+			output[i].iov_base = const_cast<std::remove_const_t<T>*>(segments_[i].data);
+			output[i].iov_len = segments_[i].size * sizeof(T);
+		}
+		return output;
+	}
+#endif
+
+	//! Destroys the elements and deallocates the blocks
+	void reset() noexcept
+	{
+		if (!segments_) { return; }
+
+		for (size_type i = 0; i < count_; ++i) {
+			const segment<T>& current = segments_[i];
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (size_type j = 0; j < current.size; ++j) {
+					AllocTraits::destroy(alloc_, current.data + j);
+				}
+			}
+
+			T* block = i == 0 ? current.data - first_offset_ : current.data;
+			AllocTraits::deallocate(alloc_, block, block_capacity_);
+		}
+
+		std::allocator<segment<T>>{}.deallocate(segments_, count_);
+		segments_ = nullptr;
+		count_ = 0;
+		first_offset_ = 0;
+		block_capacity_ = 0;
+		total_size_ = 0;
+	}
+
+private:
+	Allocator alloc_{};
+	segment<T>* segments_ = nullptr;
+	size_type count_ = 0;
+	size_type first_offset_ = 0;
+	size_type block_capacity_ = 0;
+	size_type total_size_ = 0;
+};
+
+/**
+ * @returns the deque's blocks as a list of segments, in order, without moving any elements
+ *
+ * The deque is left empty. Blocks which hold no elements are deallocated.
+ * If an exception is thrown, the deque is unchanged.
+ */
+template<typename T, typename Alloc>
+auto steal_segments(std::deque<T, Alloc>&& input) -> segment_list<T, Alloc>
+{
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+
+	const auto size = input.size();
+	Alloc alloc = input.get_allocator();
+
+#if !defined(BT_COPY_BUFFERS)
+	constexpr auto block_size = detail::deque_block_size<T, Alloc>();
+
+	const auto offset = detail::deque_blocks(input).start % block_size;
+	const auto count = size > 0 ? (offset + size - 1) / block_size + 1 : 0;
+
+	// Moving may allocate a new map for `input`, but leaves it unchanged if that throws
+	std::deque<T, Alloc> owner{std::move(input)};
+
+	segment<T>* segments = nullptr;
+	if (count > 0) {
+		try {
+			segments = std::allocator<segment<T>>{}.allocate(count);
+		} catch (...) {
+			owner.swap(input);
+			throw;
+		}
+	}
+
+	const auto blocks = detail::deque_blocks(owner);
+	const auto first = blocks.start / block_size;
+
+	std::size_t index = 0;
+	std::size_t remaining = size;
+	for (T** block = blocks.begin; block != blocks.end; ++block) {
+		const auto position = static_cast<std::size_t>(block - blocks.begin);
+		if (position < first || remaining == 0) {
+			std::allocator_traits<Alloc>::deallocate(alloc, *block, block_size);
+			continue;
+		}
+
+		const auto skip = position == first ? offset : 0;
+		const auto length = std::min(block_size - skip, remaining);
+		segments[index++] = segment<T>{*block + skip, length};
+		remaining -= length;
+	}
+
+	detail::forget_blocks(owner);
+	return segment_list<T, Alloc>{segments, count, offset, block_size, alloc};
+#else
+	if (size == 0) { return segment_list<T, Alloc>{alloc}; }
+
+	buffer<T, Alloc> copy{std::allocator_traits<Alloc>::allocate(alloc, size), 0, size, alloc};
+	std::uninitialized_copy(input.begin(), input.end(), copy.data());
+	copy.commit(size);
+
+	auto* segments = std::allocator<segment<T>>{}.allocate(1);
+	segments[0] = segment<T>{copy.release(), size};
+	input.clear();
+	return segment_list<T, Alloc>{segments, 1, 0, size, alloc};
+#endif
+}
+
+} // namespace bt
+
+#undef BUFFER_THIEF_DEQUE_IMPLEMENTED
+
+#endif // BUFFER_THIEF_DEQUE_H
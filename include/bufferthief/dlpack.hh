@@ -0,0 +1,223 @@
+/*
+ * dlpack.hh - Utility for exporting vectors as DLPack tensors
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_DLPACK_H
+#define BUFFER_THIEF_DLPACK_H
+
+#include "vector.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<dlpack/dlpack.h>)
+#	include <dlpack/dlpack.h>
+#elif !defined(DLPACK_DLPACK_H_)
+#define DLPACK_DLPACK_H_
+
+// ABI-stable definitions from https://github.com/dmlc/dlpack (v0.8)
+#define DLPACK_VERSION 80
+#define DLPACK_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	kDLCPU = 1,
+	kDLCUDA = 2,
+	kDLCUDAHost = 3,
+	kDLOpenCL = 4,
+	kDLVulkan = 7,
+	kDLMetal = 8,
+	kDLVPI = 9,
+	kDLROCM = 10,
+	kDLROCMHost = 11,
+	kDLExtDev = 12,
+	kDLCUDAManaged = 13,
+	kDLOneAPI = 14,
+	kDLWebGPU = 15,
+	kDLHexagon = 16,
+} DLDeviceType;
+
+typedef struct {
+	DLDeviceType device_type;
+	int32_t device_id;
+} DLDevice;
+
+typedef enum {
+	kDLInt = 0U,
+	kDLUInt = 1U,
+	kDLFloat = 2U,
+	kDLOpaqueHandle = 3U,
+	kDLBfloat = 4U,
+	kDLComplex = 5U,
+	kDLBool = 6U,
+} DLDataTypeCode;
+
+typedef struct {
+	uint8_t code;
+	uint8_t bits;
+	uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+	void* data;
+	DLDevice device;
+	int32_t ndim;
+	DLDataType dtype;
+	int64_t* shape;
+	int64_t* strides;
+	uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+	DLTensor dl_tensor;
+	void* manager_ctx;
+	void (*deleter)(struct DLManagedTensor* self);
+} DLManagedTensor;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // DLPACK_DLPACK_H_
+
+namespace bt {
+
+namespace detail {
+
+//! @returns DLPack data type of an integer or floating-point element type
+template<typename T>
+constexpr auto dlpack_type() noexcept -> DLDataType
+{
+	// std::vector<bool> is packed, so it has no buffer of bools to export
+	static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8,
+		"Element type has no DLPack data type");
+
+	std::uint8_t code;
+	if constexpr (std::is_floating_point_v<T>) { code = kDLFloat; }
+	else if constexpr (std::is_signed_v<T>) { code = kDLInt; }
+	else { code = kDLUInt; }
+
+	return DLDataType{code, static_cast<std::uint8_t>(sizeof(T) * 8), 1};
+}
+
+/**
+ * Owns the stolen buffer of an exported tensor. It is allocated together with the
+ * shape, which follows it in the same block.
+ */
+template<typename T, typename Alloc>
+struct DLPackContext
+{
+	DLManagedTensor tensor;
+	std::size_t capacity;
+
+	static auto block_size(std::int32_t ndim) noexcept -> std::size_t
+	{
+		return sizeof(DLPackContext) + static_cast<std::size_t>(ndim) * sizeof(std::int64_t);
+	}
+
+	static void deleter(DLManagedTensor* self)
+	{
+		auto* context = static_cast<DLPackContext*>(self->manager_ctx);
+		const auto ndim = self->dl_tensor.ndim;
+
+		if (auto* data = static_cast<T*>(self->dl_tensor.data)) {
+			Alloc alloc;
+			std::allocator_traits<Alloc>::deallocate(alloc, data, context->capacity);
+		}
+
+		context->~DLPackContext();
+		std::allocator<unsigned char>{}.deallocate(reinterpret_cast<unsigned char*>(context), block_size(ndim));
+	}
+};
+
+} // namespace detail
+
+/**
+ * @brief Exports the vector as a contiguous CPU tensor without copying its contents.
+ *
+ * The vector's buffer is stolen, and the tensor's deleter frees it through the vector's
+ * allocator. The consumer must call the deleter exactly once. Only stateless allocators
+ * are supported.
+ *
+ * @throws std::invalid_argument if the product of `shape` is not the vector's size or
+ * overflows, in which case the vector is unchanged
+ */
+template<typename T, typename Alloc>
+auto to_dlpack(std::vector<T, Alloc>&& input, std::initializer_list<std::int64_t> shape) -> DLManagedTensor*
+{
+	static_assert(std::allocator_traits<Alloc>::is_always_equal::value
+		&& std::is_default_constructible_v<Alloc>, "Stateful allocators are not supported");
+
+	using Context = detail::DLPackContext<T, Alloc>;
+
+	// A zero extent makes the product zero, however large the others are
+	std::int64_t elements = 1;
+	for (const auto extent : shape) {
+		if (extent < 0) { throw std::invalid_argument{"to_dlpack: negative extent"}; }
+		if (extent == 0) { elements = 0; }
+	}
+	for (const auto extent : shape) {
+		if (elements == 0) { break; }
+		if (elements > std::numeric_limits<std::int64_t>::max() / extent) {
+			throw std::invalid_argument{"to_dlpack: shape has too many elements"};
+		}
+		elements *= extent;
+	}
+	if (static_cast<std::uint64_t>(elements) != input.size()) {
+		throw std::invalid_argument{"to_dlpack: shape does not match the vector's size"};
+	}
+
+	// Allocate before stealing, so the vector is unchanged if this throws
+	const auto ndim = static_cast<std::int32_t>(shape.size());
+	auto* block = std::allocator<unsigned char>{}.allocate(Context::block_size(ndim));
+	auto* context = ::new (static_cast<void*>(block)) Context{};
+	auto* extents = reinterpret_cast<std::int64_t*>(block + sizeof(Context));
+	std::uninitialized_copy(shape.begin(), shape.end(), extents);
+
+	auto stolen = bt::steal(std::move(input));
+	context->capacity = stolen.capacity();
+
+	DLTensor& tensor = context->tensor.dl_tensor;
+	tensor.data = stolen.release();
+	tensor.device = DLDevice{kDLCPU, 0};
+	tensor.ndim = ndim;
+	tensor.dtype = detail::dlpack_type<T>();
+	tensor.shape = extents;
+	tensor.strides = nullptr; // compact row-major
+	tensor.byte_offset = 0;
+
+	context->tensor.manager_ctx = context;
+	context->tensor.deleter = &Context::deleter;
+	return &context->tensor;
+}
+
+//! @returns the vector exported as a one-dimensional tensor
+template<typename T, typename Alloc>
+auto to_dlpack(std::vector<T, Alloc>&& input) -> DLManagedTensor*
+{
+	const auto size = static_cast<std::int64_t>(input.size());
+	return bt::to_dlpack(std::move(input), {size});
+}
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_DLPACK_H
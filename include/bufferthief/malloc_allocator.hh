@@ -0,0 +1,93 @@
+/*
+ * malloc_allocator.hh - Allocator whose buffers can be released with std::free
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_MALLOC_ALLOCATOR_H
+#define BUFFER_THIEF_MALLOC_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace bt {
+
+/**
+ * @brief Stateless allocator which allocates with std::malloc and deallocates with std::free.
+ *
+ * Buffers stolen from containers which use it may be handed to C code, or to any other
+ * language runtime, which takes ownership with free() or realloc().
+ */
+template<typename T>
+class malloc_allocator
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_move_assignment = std::true_type;
+	using is_always_equal = std::true_type;
+
+	constexpr malloc_allocator() noexcept = default;
+
+	template<typename U>
+	constexpr malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+	auto allocate(std::size_t n) -> T*
+	{
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length{};
+		}
+
+		// malloc(0) may return nullptr, which would be mistaken for failure
+		void* p = std::malloc(n > 0 ? n * sizeof(T) : 1);
+		if (!p) { throw std::bad_alloc{}; }
+
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, std::size_t) noexcept
+	{
+		std::free(p);
+	}
+
+	template<typename U>
+	friend constexpr auto operator==(const malloc_allocator&, const malloc_allocator<U>&) noexcept -> bool { return true; }
+
+	template<typename U>
+	friend constexpr auto operator!=(const malloc_allocator&, const malloc_allocator<U>&) noexcept -> bool { return false; }
+};
+
+//! String whose buffer is allocated by std::malloc
+template<typename CharT>
+using basic_string = std::basic_string<CharT, std::char_traits<CharT>, malloc_allocator<CharT>>;
+
+using string = basic_string<char>;
+using wstring = basic_string<wchar_t>;
+#if defined(__cpp_lib_char8_t)
+using u8string = basic_string<char8_t>;
+#endif
+using u16string = basic_string<char16_t>;
+using u32string = basic_string<char32_t>;
+
+//! Vector whose buffer is allocated by std::malloc
+template<typename T>
+using vector = std::vector<T, malloc_allocator<T>>;
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_MALLOC_ALLOCATOR_H
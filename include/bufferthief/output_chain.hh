@@ -0,0 +1,292 @@
+/*
+ * output_chain.hh - Gather output of stolen buffers with writev
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_OUTPUT_CHAIN_H
+#define BUFFER_THIEF_OUTPUT_CHAIN_H
+
+#include "buffer.hh"
+#include "string.hh"
+#include "vector.hh"
+
+#if __has_include(<sys/uio.h>)
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bt {
+
+/**
+ * @brief Queue of byte ranges written to a file descriptor with writev, owning the buffers they point into.
+ *
+ * Strings and vectors are stolen when appended, so their contents are never copied. Small
+ * strings, which cannot be stolen, are packed into shared chunks instead, and adjacent ones are
+ * written as a single range. Each buffer is released as soon as all of its bytes are written.
+ */
+class output_chain
+{
+public:
+	//! Largest string in bytes which is copied into a shared chunk when it cannot be stolen
+	static constexpr std::size_t max_packed_size = 256;
+
+	//! Bytes in each shared chunk, including its header
+	static constexpr std::size_t chunk_size = 4096;
+
+#if defined(IOV_MAX)
+	static constexpr std::size_t max_ranges_per_write = IOV_MAX;
+#else
+	static constexpr std::size_t max_ranges_per_write = 16; // _XOPEN_IOV_MAX
+#endif
+
+	output_chain() = default;
+
+	output_chain(output_chain&& other) noexcept
+		: segments_{std::move(other.segments_)}
+		, size_{std::exchange(other.size_, 0)}
+		, chunk_{std::exchange(other.chunk_, nullptr)}
+	{
+		other.segments_.clear();
+	}
+
+	auto operator=(output_chain&& other) noexcept -> output_chain&
+	{
+		if (this != &other) {
+			clear();
+			segments_ = std::move(other.segments_);
+			other.segments_.clear();
+			size_ = std::exchange(other.size_, 0);
+			chunk_ = std::exchange(other.chunk_, nullptr);
+		}
+		return *this;
+	}
+
+	output_chain(const output_chain&) = delete;
+	auto operator=(const output_chain&) -> output_chain& = delete;
+
+	~output_chain()
+	{
+		clear();
+	}
+
+	//! Bytes not yet written
+	auto size() const noexcept -> std::size_t { return size_; }
+
+	auto empty() const noexcept -> bool { return size_ == 0; }
+
+	//! Number of ranges not yet written
+	auto ranges() const noexcept -> std::size_t { return segments_.size(); }
+
+	//! Appends the string's contents, not including the null terminator
+	template<typename CharT, typename Alloc>
+	void append(std::basic_string<CharT, std::char_traits<CharT>, Alloc>&& input)
+	{
+		if (input.empty()) { return; }
+
+		if (auto stolen = bt::try_steal(input)) {
+			append(std::move(stolen));
+		} else if (input.size() * sizeof(CharT) <= max_packed_size) {
+			pack(input.data(), input.size() * sizeof(CharT));
+		} else {
+			append(bt::steal(std::move(input)));
+		}
+	}
+
+	template<typename T, typename Alloc>
+	void append(std::vector<T, Alloc>&& input)
+	{
+		if (input.empty()) { return; }
+		append(bt::steal(std::move(input)));
+	}
+
+	template<typename T, typename Alloc>
+	void append(buffer<T, Alloc>&& input)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Elements must be trivially copyable");
+		static_assert(std::allocator_traits<Alloc>::is_always_equal::value
+			&& std::is_default_constructible_v<Alloc>, "Stateful allocators are not supported");
+
+		if (input.empty()) { return; }
+
+		segments_.emplace_back();
+		Segment& segment = segments_.back();
+		segment.size = input.size() * sizeof(T);
+		segment.owner_capacity = input.capacity();
+		segment.release = &release_buffer<T, Alloc>;
+		segment.owner = input.release();
+		segment.data = static_cast<const std::byte*>(segment.owner);
+
+		size_ += segment.size;
+	}
+
+	/**
+	 * @brief Writes to `fd` until the chain is empty or `fd` would block.
+	 *
+	 * Each writev call covers at most `max_ranges_per_write` ranges. Partially written
+	 * ranges are resumed on the next call.
+	 *
+	 * @returns number of bytes written
+	 * @throws std::system_error if writev fails for any reason other than EINTR, EAGAIN, or EWOULDBLOCK
+	 */
+	auto flush(int fd) -> std::size_t
+	{
+		std::size_t total = 0;
+		while (!segments_.empty()) {
+			const auto count = std::min(segments_.size(), max_ranges_per_write);
+			iovecs_.resize(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				iovecs_[i].iov_base = const_cast<std::byte*>(segments_[i].data);
+				iovecs_[i].iov_len = segments_[i].size;
+			}
+
+			const auto written = ::writev(fd, iovecs_.data(), static_cast<int>(count));
+			if (written < 0) {
+				if (errno == EINTR) { continue; }
+				if (errno == EAGAIN || errno == EWOULDBLOCK) { break; }
+				throw std::system_error{errno, std::generic_category(), "writev"};
+			}
+
+			consume(static_cast<std::size_t>(written));
+			total += static_cast<std::size_t>(written);
+		}
+		return total;
+	}
+
+	//! Releases every buffer without writing it
+	void clear() noexcept
+	{
+		for (auto& segment : segments_) {
+			segment.release(segment.owner, segment.owner_capacity);
+		}
+		segments_.clear();
+		size_ = 0;
+
+		if (chunk_) {
+			release_chunk(std::exchange(chunk_, nullptr), 0);
+		}
+	}
+
+private:
+	struct Segment
+	{
+		const std::byte* data;
+		std::size_t size;
+		void* owner; //!< buffer or chunk to release once every byte is written
+		std::size_t owner_capacity;
+		void (*release)(void* owner, std::size_t capacity) noexcept;
+	};
+
+	//! Header at the start of each shared chunk
+	struct Chunk
+	{
+		std::size_t references;
+		std::size_t used;
+
+		auto data() noexcept -> std::byte* { return reinterpret_cast<std::byte*>(this) + sizeof(Chunk); }
+	};
+
+	static constexpr std::size_t chunk_capacity = chunk_size - sizeof(Chunk);
+	static_assert(max_packed_size <= chunk_capacity);
+
+	template<typename T, typename Alloc>
+	static void release_buffer(void* owner, std::size_t capacity) noexcept
+	{
+		Alloc alloc;
+		std::allocator_traits<Alloc>::deallocate(alloc, static_cast<T*>(owner), capacity);
+	}
+
+	static void release_chunk(void* owner, std::size_t) noexcept
+	{
+		auto* chunk = static_cast<Chunk*>(owner);
+		if (--chunk->references == 0) {
+			std::allocator<std::byte>{}.deallocate(reinterpret_cast<std::byte*>(chunk), chunk_size);
+		}
+	}
+
+	//! Copies a small string into the current chunk, extending the last range when it is adjacent
+	void pack(const void* data, std::size_t size)
+	{
+		if (!chunk_ || chunk_capacity - chunk_->used < size) {
+			auto* memory = std::allocator<std::byte>{}.allocate(chunk_size);
+			auto* chunk = ::new (static_cast<void*>(memory)) Chunk{1, 0};
+			if (chunk_) {
+				release_chunk(chunk_, 0);
+			}
+			chunk_ = chunk;
+		}
+
+		std::byte* dest = chunk_->data() + chunk_->used;
+		std::memcpy(dest, data, size);
+		chunk_->used += size;
+		size_ += size;
+
+		if (!segments_.empty()) {
+			Segment& last = segments_.back();
+			if (last.owner == chunk_ && last.data + last.size == dest) {
+				last.size += size;
+				return;
+			}
+		}
+
+		segments_.emplace_back();
+		Segment& segment = segments_.back();
+		segment.data = dest;
+		segment.size = size;
+		segment.owner = chunk_;
+		segment.owner_capacity = 0;
+		segment.release = &release_chunk;
+		++chunk_->references;
+	}
+
+	//! Drops `bytes` from the front of the chain, releasing fully written ranges
+	void consume(std::size_t bytes) noexcept
+	{
+		size_ -= bytes;
+		while (bytes > 0) {
+			Segment& segment = segments_.front();
+			if (bytes < segment.size) {
+				segment.data += bytes;
+				segment.size -= bytes;
+				return;
+			}
+
+			bytes -= segment.size;
+			segment.release(segment.owner, segment.owner_capacity);
+			segments_.pop_front();
+		}
+	}
+
+	std::deque<Segment> segments_;
+	std::size_t size_ = 0;
+
+	//! Chunk which small strings are packed into, holding a reference until it is full
+	Chunk* chunk_ = nullptr;
+
+	std::vector<::iovec> iovecs_;
+};
+
+} // namespace bt
+
+#endif // __has_include(<sys/uio.h>)
+
+#endif // BUFFER_THIEF_OUTPUT_CHAIN_H
@@ -0,0 +1,56 @@
+/*
+ * path.hh - Utility for stealing the native string of std::filesystem::path
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_PATH_H
+#define BUFFER_THIEF_PATH_H
+
+#include "string.hh"
+
+#include <filesystem>
+#include <utility>
+
+#undef BUFFER_THIEF_PATH_IMPLEMENTED
+#if !defined(BT_COPY_BUFFERS)
+#	include "private/path_libc++.hh"
+#	include "private/path_libstdc++.hh"
+#	include "private/path_msvc_stl.hh"
+#	if !defined(BUFFER_THIEF_PATH_IMPLEMENTED)
+#		error "No supported C++ Standard Library implementation detected"
+#	endif
+#endif
+
+namespace bt {
+
+/**
+ * @returns native string of the path, stealing its buffer when possible and copying it if not
+ *
+ * The buffer's capacity() includes the null terminator. The path is left empty.
+ */
+inline auto steal(std::filesystem::path&& input) -> buffer<std::filesystem::path::value_type>
+{
+#if !defined(BT_COPY_BUFFERS)
+	auto result = bt::steal(std::move(detail::native_string(input)));
+#else
+	auto result = detail::copy_string(input.native());
+#endif
+
+	// Also resets any parsed components
+	input.clear();
+	return result;
+}
+
+} // namespace bt
+
+#undef BUFFER_THIEF_PATH_IMPLEMENTED
+
+#endif // BUFFER_THIEF_PATH_H
@@ -0,0 +1,120 @@
+/*
+ * bit_vector_libc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "common_vector.hh"
+
+// Defined outside the guard below, since <bufferthief/shm_allocator.hh> includes this header
+// again to instantiate it for its allocator. Undefined at the end of this header.
+#if defined(_LIBCPP_VERSION)
+// std::vector<bool, Alloc> does not depend on an element type, so each one is instantiated directly
+#	if _LIBCPP_VERSION >= 200000
+#		define BT_BIT_VECTOR_ACCESSORS(BitVector) \
+	template struct MemberAccessor<BitBeginTarget<BitVector>, &BitVector::__begin_>; \
+	template struct MemberAccessor<BitSizeTarget<BitVector>, &BitVector::__size_>; \
+	template struct MemberAccessor<BitCapTarget<BitVector>, &BitVector::__cap_>;
+#	else
+#		define BT_BIT_VECTOR_ACCESSORS(BitVector) \
+	template struct MemberAccessor<BitBeginTarget<BitVector>, &BitVector::__begin_>; \
+	template struct MemberAccessor<BitSizeTarget<BitVector>, &BitVector::__size_>; \
+	template struct MemberAccessor<BitCapTarget<BitVector>, &BitVector::__cap_alloc_>;
+#	endif
+#endif
+
+#if !defined(BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED) && !defined(BUFFER_THIEF_SHM_ACCESSORS)
+
+#if defined(_LIBCPP_VERSION)
+#define BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
+
+#if _LIBCPP_VERSION < 15000
+#	error "libc++ 15 or newer is required"
+#endif
+
+#include "member_accessor.hh"
+
+#include <cstddef>
+
+namespace bt::detail {
+
+//! Type of the words which std::vector<bool> packs its bits into
+using BitWord = std::size_t;
+
+template<typename BitVector>
+struct BitBeginTarget
+{
+	friend constexpr auto get(BitBeginTarget, BitVector&) -> BitWord*&;
+};
+
+template<typename BitVector>
+struct BitSizeTarget
+{
+	friend constexpr auto get(BitSizeTarget, BitVector&) -> std::size_t&;
+};
+
+template<typename BitVector>
+struct BitCapTarget
+{
+#if _LIBCPP_VERSION >= 200000
+	using Member = std::size_t;
+#else
+	using WordAlloc = typename std::allocator_traits<typename BitVector::allocator_type>::template rebind_alloc<BitWord>;
+	using Member = std::__compressed_pair<std::size_t, WordAlloc>;
+#endif
+
+	friend constexpr auto get(BitCapTarget, BitVector&) -> Member&;
+};
+
+BT_BIT_VECTOR_ACCESSORS(std::vector<bool>)
+BT_BIT_VECTOR_ACCESSORS(bt::vector<bool>)
+#if defined(__cpp_lib_memory_resource)
+BT_BIT_VECTOR_ACCESSORS(std::pmr::vector<bool>)
+#endif
+
+/**
+ * @returns internal word array of the vector, or nullptr if it has none
+ * @param capacity receives the number of words allocated
+ */
+template<typename Alloc>
+inline auto steal_bits(std::vector<bool, Alloc>& input, std::size_t& capacity) noexcept -> BitWord*
+{
+	using BitVector = std::vector<bool, Alloc>;
+
+#if _LIBCPP_VERSION >= 200000
+	std::size_t& cap = get(BitCapTarget<BitVector>{}, input);
+#else
+	std::size_t& cap = get(BitCapTarget<BitVector>{}, input).first();
+#endif
+
+	BitWord* ptr = get(BitBeginTarget<BitVector>{}, input);
+	capacity = ptr ? cap : 0;
+
+	get(BitBeginTarget<BitVector>{}, input) = nullptr;
+	get(BitSizeTarget<BitVector>{}, input) = 0;
+	cap = 0;
+
+	return ptr;
+}
+
+} // namespace bt::detail
+
+#endif // _LIBCPP_VERSION
+#endif // BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
+
+// Opt-in hook for <bufferthief/shm_allocator.hh>, which includes this header again with
+// BUFFER_THIEF_SHM_ACCESSORS defined once its types are declared
+#if defined(_LIBCPP_VERSION) && defined(BUFFER_THIEF_SHM_ACCESSORS)
+namespace bt::detail {
+BT_BIT_VECTOR_ACCESSORS(bt::shm_vector<bool>)
+} // namespace bt::detail
+#endif
+
+#undef BT_BIT_VECTOR_ACCESSORS
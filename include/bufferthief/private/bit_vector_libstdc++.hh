@@ -0,0 +1,70 @@
+/*
+ * bit_vector_libstdc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
+
+#include "common_vector.hh"
+
+#if defined(__GLIBCXX__)
+#define BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
+
+#include <cstddef>
+#include <type_traits>
+
+namespace bt::detail {
+
+//! Type of the words which std::vector<bool> packs its bits into
+using BitWord = std::_Bit_type;
+
+/**
+ * std::_Bvector_base::_M_impl is protected, so it is reached through a pointer to
+ * member formed in a derived class, as with std::deque.
+ */
+template<typename Alloc>
+struct BitVectorAccess : std::_Bvector_base<Alloc>
+{
+	static auto impl(std::vector<bool, Alloc>& input) noexcept -> auto&
+	{
+		using Base = std::_Bvector_base<Alloc>;
+
+		static_assert(std::is_base_of_v<Base, std::vector<bool, Alloc>>);
+
+		// C-style cast allows converting derived class to inaccessible base class
+		return ((Base&)input).*(&BitVectorAccess::_M_impl);
+	}
+};
+
+/**
+ * @returns internal word array of the vector, or nullptr if it has none
+ * @param capacity receives the number of words allocated
+ */
+template<typename Alloc>
+inline auto steal_bits(std::vector<bool, Alloc>& input, std::size_t& capacity) noexcept -> BitWord*
+{
+	auto& impl = BitVectorAccess<Alloc>::impl(input);
+
+	// The first bit is always at the start of the first word
+	BitWord* ptr = impl._M_start._M_p;
+	capacity = ptr ? static_cast<std::size_t>(impl._M_end_of_storage - ptr) : 0;
+
+	impl._M_start = std::_Bit_iterator();
+	impl._M_finish = std::_Bit_iterator();
+	impl._M_end_of_storage = nullptr;
+
+	return ptr;
+}
+
+} // namespace bt::detail
+
+#endif // __GLIBCXX__
+#endif // BUFFER_THIEF_BIT_VECTOR_IMPLEMENTED
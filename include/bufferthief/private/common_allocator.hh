@@ -0,0 +1,46 @@
+/*
+ * common_allocator.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_COMMON_ALLOCATOR_H
+#define BUFFER_THIEF_COMMON_ALLOCATOR_H
+
+#include "../malloc_allocator.hh"
+
+#include <memory>
+
+// libc++ 15 only provides <experimental/memory_resource>
+#if __has_include(<memory_resource>)
+#	include <memory_resource>
+#endif
+
+namespace bt::detail {
+
+/**
+ * Allocators whose containers have the internal accessors instantiated.
+ * Supporting another allocator requires explicit instantiations in each implementation.
+ */
+template<typename Alloc>
+struct SupportedAllocator
+{
+	static constexpr bool value = false;
+};
+
+template<typename T> struct SupportedAllocator<std::allocator<T>> { static constexpr bool value = true; };
+template<typename T> struct SupportedAllocator<malloc_allocator<T>> { static constexpr bool value = true; };
+#if defined(__cpp_lib_memory_resource)
+template<typename T> struct SupportedAllocator<std::pmr::polymorphic_allocator<T>> { static constexpr bool value = true; };
+#endif
+
+} // namespace bt::detail
+
+#endif // BUFFER_THIEF_COMMON_ALLOCATOR_H
@@ -0,0 +1,65 @@
+/*
+ * common_sstream.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_COMMON_SSTREAM_H
+#define BUFFER_THIEF_COMMON_SSTREAM_H
+
+#include "common_string.hh"
+
+#include <sstream>
+#include <streambuf>
+
+namespace bt::detail {
+
+/**
+ * @brief Exposes the protected put and get area accessors of std::basic_streambuf.
+ *
+ * Never instantiated. Naming the members through this class yields member pointers
+ * of std::basic_streambuf which may be used with any stream buffer.
+ */
+template<typename CharT>
+struct StreambufAccess : std::basic_streambuf<CharT>
+{
+	using std::basic_streambuf<CharT>::eback;
+	using std::basic_streambuf<CharT>::egptr;
+	using std::basic_streambuf<CharT>::pbase;
+	using std::basic_streambuf<CharT>::pptr;
+};
+
+template<typename CharT>
+inline auto pbase(const std::basic_streambuf<CharT>& input) noexcept -> CharT*
+{
+	return (input.*&StreambufAccess<CharT>::pbase)();
+}
+
+template<typename CharT>
+inline auto pptr(const std::basic_streambuf<CharT>& input) noexcept -> CharT*
+{
+	return (input.*&StreambufAccess<CharT>::pptr)();
+}
+
+template<typename CharT>
+inline auto eback(const std::basic_streambuf<CharT>& input) noexcept -> CharT*
+{
+	return (input.*&StreambufAccess<CharT>::eback)();
+}
+
+template<typename CharT>
+inline auto egptr(const std::basic_streambuf<CharT>& input) noexcept -> CharT*
+{
+	return (input.*&StreambufAccess<CharT>::egptr)();
+}
+
+} // namespace bt::detail
+
+#endif // BUFFER_THIEF_COMMON_SSTREAM_H
@@ -20,6 +20,8 @@
 #	error BufferThief requires at least C++17
 #endif
 
+#include "common_allocator.hh"
+
 #include <memory>
 #include <string>
 
@@ -51,6 +53,9 @@ template<> struct SupportedChar<char8_t> { static constexpr bool value = true; }
 template<> struct SupportedChar<char16_t> { static constexpr bool value = true; };
 template<> struct SupportedChar<char32_t> { static constexpr bool value = true; };
 
+template<typename CharT, typename Alloc = std::allocator<CharT>>
+using String = std::basic_string<CharT, std::char_traits<CharT>, Alloc>;
+
 } // namespace bt::detail
 
 #endif //  BUFFER_THIEF_COMMON_STRING_H
@@ -20,6 +20,9 @@
 #	error BufferThief requires at least C++17
 #endif
 
+#include "common_allocator.hh"
+
+#include <iterator>
 #include <memory>
 #include <vector>
 
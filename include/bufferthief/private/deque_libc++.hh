@@ -0,0 +1,186 @@
+/*
+ * deque_libc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "common_deque.hh"
+
+// Defined outside the guard below, since <bufferthief/shm_allocator.hh> includes this header
+// again to instantiate it for its allocator. Undefined at the end of this header.
+#if defined(_LIBCPP_VERSION)
+#	define BT_DEQUE_ACCESSORS(Probe) \
+	template struct MemberAccessor<DequeMapTarget<Probe>, &Probe::__map_>; \
+	template struct MemberAccessor<DequeStartTarget<Probe>, &Probe::__start_>; \
+	template struct MemberAccessor<DequeSizeTarget<Probe>, &Probe::__size_>;
+#endif
+
+#if !defined(BUFFER_THIEF_DEQUE_IMPLEMENTED) && !defined(BUFFER_THIEF_SHM_ACCESSORS)
+
+#if defined(_LIBCPP_VERSION)
+#define BUFFER_THIEF_DEQUE_IMPLEMENTED
+
+#if _LIBCPP_VERSION < 15000
+#	error "libc++ 15 or newer is required"
+#endif
+
+#include "member_accessor.hh"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace bt::detail {
+
+/**
+ * As with std::vector, the member offsets are taken from this instantiation and
+ * applied to std::deque<T, Alloc>, which has the same layout for every T.
+ */
+template<typename Alloc>
+using DequeProbe = std::deque<unsigned char, typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char>>;
+
+template<typename Probe>
+using DequeProbeMap = std::__split_buffer<unsigned char*,
+	typename std::allocator_traits<typename Probe::allocator_type>::template rebind_alloc<unsigned char*>>;
+
+template<typename Probe>
+struct DequeMapTarget
+{
+	friend constexpr auto get(DequeMapTarget, Probe&) -> DequeProbeMap<Probe>&;
+};
+
+template<typename Probe>
+struct DequeStartTarget
+{
+	friend constexpr auto get(DequeStartTarget, Probe&) -> typename Probe::size_type&;
+};
+
+template<typename Probe>
+struct DequeSizeTarget
+{
+#if _LIBCPP_VERSION >= 200000
+	using Member = typename Probe::size_type;
+#else
+	using Member = std::__compressed_pair<typename Probe::size_type, typename Probe::allocator_type>;
+#endif
+
+	friend constexpr auto get(DequeSizeTarget, Probe&) -> Member&;
+};
+
+BT_DEQUE_ACCESSORS(std::deque<unsigned char>)
+// Spelled as DequeProbe, since a comma in the template arguments would split the macro argument
+BT_DEQUE_ACCESSORS(DequeProbe<bt::malloc_allocator<unsigned char>>)
+#if defined(__cpp_lib_memory_resource)
+BT_DEQUE_ACCESSORS(std::pmr::deque<unsigned char>)
+#endif
+
+struct DequeLayout
+{
+	std::size_t map;
+	std::size_t start;
+	std::size_t size;
+};
+
+//! @returns byte offsets of the members within std::deque<T, Alloc>, measured on a probe the first time
+template<typename Alloc>
+inline auto deque_layout() noexcept -> const DequeLayout&
+{
+	using Probe = DequeProbe<Alloc>;
+	using ProbeAlloc = typename Probe::allocator_type;
+
+	// The block map, the start index, and the size stored alongside the allocator unless it is empty
+	static_assert(sizeof(Probe) == sizeof(DequeProbeMap<Probe>) + 2 * sizeof(typename Probe::size_type)
+		+ (std::is_empty_v<ProbeAlloc> ? 0 : sizeof(ProbeAlloc)), "Unexpected std::deque layout");
+
+	static const DequeLayout layout = [] {
+		Probe probe;
+
+		auto offset = [&](void* member) -> std::size_t {
+			return static_cast<unsigned char*>(member) - reinterpret_cast<unsigned char*>(&probe);
+		};
+
+#if _LIBCPP_VERSION >= 200000
+		auto* size = &get(DequeSizeTarget<Probe>{}, probe);
+#else
+		auto* size = &get(DequeSizeTarget<Probe>{}, probe).first();
+#endif
+
+		return DequeLayout{
+			offset(&get(DequeMapTarget<Probe>{}, probe)),
+			offset(&get(DequeStartTarget<Probe>{}, probe)),
+			offset(size)
+		};
+	}();
+
+	return layout;
+}
+
+template<typename Member, typename T, typename Alloc>
+inline auto deque_member(std::deque<T, Alloc>& input, std::size_t offset) noexcept -> Member&
+{
+	static_assert(sizeof(std::deque<T, Alloc>) == sizeof(DequeProbe<Alloc>), "std::deque layout depends on T");
+	static_assert(alignof(std::deque<T, Alloc>) == alignof(DequeProbe<Alloc>), "std::deque layout depends on T");
+
+	return *reinterpret_cast<Member*>(reinterpret_cast<unsigned char*>(&input) + offset);
+}
+
+//! Number of elements in each block
+template<typename T, typename Alloc>
+constexpr auto deque_block_size() noexcept -> std::size_t
+{
+	using Difference = typename std::allocator_traits<Alloc>::difference_type;
+	return static_cast<std::size_t>(std::__deque_block_size<T, Difference>::value);
+}
+
+template<typename T, typename Alloc>
+inline auto deque_blocks(std::deque<T, Alloc>& input) noexcept -> DequeBlocks<T>
+{
+	using Probe = DequeProbe<Alloc>;
+
+	const DequeLayout& layout = deque_layout<Alloc>();
+	auto& map = deque_member<DequeProbeMap<Probe>>(input, layout.map);
+
+	// The map may hold spare blocks before and after the elements
+	return DequeBlocks<T>{
+		reinterpret_cast<T**>(map.begin()),
+		reinterpret_cast<T**>(map.end()),
+		deque_member<std::size_t>(input, layout.start)
+	};
+}
+
+/**
+ * @brief Empties the map without touching the blocks or the elements in them.
+ * `input` may only be destroyed afterward.
+ */
+template<typename T, typename Alloc>
+inline void forget_blocks(std::deque<T, Alloc>& input) noexcept
+{
+	using Probe = DequeProbe<Alloc>;
+
+	const DequeLayout& layout = deque_layout<Alloc>();
+
+	deque_member<DequeProbeMap<Probe>>(input, layout.map).clear();
+	deque_member<std::size_t>(input, layout.start) = 0;
+	deque_member<std::size_t>(input, layout.size) = 0;
+}
+
+} // namespace bt::detail
+
+#endif // _LIBCPP_VERSION
+#endif // BUFFER_THIEF_DEQUE_IMPLEMENTED
+
+// Opt-in hook for <bufferthief/shm_allocator.hh>, which includes this header again with
+// BUFFER_THIEF_SHM_ACCESSORS defined once its types are declared
+#if defined(_LIBCPP_VERSION) && defined(BUFFER_THIEF_SHM_ACCESSORS)
+namespace bt::detail {
+BT_DEQUE_ACCESSORS(DequeProbe<bt::shm_allocator<unsigned char>>)
+} // namespace bt::detail
+#endif
+
+#undef BT_DEQUE_ACCESSORS
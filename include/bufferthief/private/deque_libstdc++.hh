@@ -0,0 +1,89 @@
+/*
+ * deque_libstdc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_DEQUE_IMPLEMENTED
+
+#include "common_deque.hh"
+
+#if defined(__GLIBCXX__)
+#define BUFFER_THIEF_DEQUE_IMPLEMENTED
+
+#include <type_traits>
+
+namespace bt::detail {
+
+/**
+ * std::_Deque_base::_M_impl is protected, so it cannot be named from outside, but a
+ * derived class may form a pointer to it. The pointer is usable with any deque, so
+ * the derived class is never instantiated as an object.
+ */
+template<typename T, typename Alloc>
+struct DequeAccess : std::_Deque_base<T, Alloc>
+{
+	static auto impl(std::deque<T, Alloc>& input) noexcept -> auto&
+	{
+		using Base = std::_Deque_base<T, Alloc>;
+
+		static_assert(std::is_base_of_v<Base, std::deque<T, Alloc>>);
+
+		// C-style cast allows converting derived class to inaccessible base class
+		return ((Base&)input).*(&DequeAccess::_M_impl);
+	}
+};
+
+//! Number of elements in each block
+template<typename T, typename Alloc>
+constexpr auto deque_block_size() noexcept -> std::size_t
+{
+	return std::__deque_buf_size(sizeof(T));
+}
+
+template<typename T, typename Alloc>
+auto deque_blocks(std::deque<T, Alloc>& input) noexcept -> DequeBlocks<T>
+{
+	auto& impl = DequeAccess<T, Alloc>::impl(input);
+	if (!impl._M_map) { return {}; }
+
+	// Every block from the first node to the last, which may be empty, is allocated
+	return DequeBlocks<T>{
+		impl._M_start._M_node,
+		impl._M_finish._M_node + 1,
+		static_cast<std::size_t>(impl._M_start._M_cur - impl._M_start._M_first)
+	};
+}
+
+/**
+ * @brief Deallocates the map without touching the blocks or the elements in them.
+ * `input` may only be destroyed afterward.
+ */
+template<typename T, typename Alloc>
+void forget_blocks(std::deque<T, Alloc>& input) noexcept
+{
+	auto& impl = DequeAccess<T, Alloc>::impl(input);
+
+	if (impl._M_map) {
+		using MapAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T*>;
+		MapAlloc alloc{input.get_allocator()};
+		std::allocator_traits<MapAlloc>::deallocate(alloc, impl._M_map, impl._M_map_size);
+	}
+
+	impl._M_map = nullptr;
+	impl._M_map_size = 0;
+	impl._M_start = {};
+	impl._M_finish = {};
+}
+
+} // namespace bt::detail
+
+#endif // __GLIBCXX__
+#endif // BUFFER_THIEF_DEQUE_IMPLEMENTED
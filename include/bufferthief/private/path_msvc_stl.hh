@@ -0,0 +1,41 @@
+/*
+ * path_msvc_stl.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_PATH_IMPLEMENTED
+
+#include <filesystem>
+
+#if defined(_MSC_VER)
+#define BUFFER_THIEF_PATH_IMPLEMENTED
+
+#include "member_accessor.hh"
+
+namespace bt::detail {
+
+struct PathStringTarget
+{
+	friend constexpr auto get(PathStringTarget, std::filesystem::path&) -> std::filesystem::path::string_type&;
+};
+
+template struct MemberAccessor<PathStringTarget, &std::filesystem::path::_Text>;
+
+//! @returns the string which holds the path's native format
+inline auto native_string(std::filesystem::path& input) noexcept -> std::filesystem::path::string_type&
+{
+	return get(PathStringTarget{}, input);
+}
+
+} // namespace bt::detail
+
+#endif // _MSC_VER
+#endif // BUFFER_THIEF_PATH_IMPLEMENTED
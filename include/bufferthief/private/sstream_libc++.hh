@@ -0,0 +1,83 @@
+/*
+ * sstream_libc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#include "common_sstream.hh"
+
+#if defined(_LIBCPP_VERSION)
+#define BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#include "member_accessor.hh"
+
+#include <utility>
+
+namespace bt::detail {
+
+template<typename CharT>
+struct StringbufTarget
+{
+	friend constexpr auto get(StringbufTarget, std::basic_stringbuf<CharT>&) -> std::basic_string<CharT>&;
+};
+
+template<typename CharT>
+struct HighMarkTarget
+{
+	friend constexpr auto get(HighMarkTarget, std::basic_stringbuf<CharT>&) -> CharT*&;
+};
+
+template<typename CharT>
+struct ModeTarget
+{
+	friend constexpr auto get(ModeTarget, std::basic_stringbuf<CharT>&) -> std::ios_base::openmode&;
+};
+
+template struct MemberAccessor<StringbufTarget<char>, &std::stringbuf::__str_>;
+template struct MemberAccessor<StringbufTarget<wchar_t>, &std::wstringbuf::__str_>;
+
+template struct MemberAccessor<HighMarkTarget<char>, &std::stringbuf::__hm_>;
+template struct MemberAccessor<HighMarkTarget<wchar_t>, &std::wstringbuf::__hm_>;
+
+template struct MemberAccessor<ModeTarget<char>, &std::stringbuf::__mode_>;
+template struct MemberAccessor<ModeTarget<wchar_t>, &std::wstringbuf::__mode_>;
+
+/**
+ * @returns contents of the stringbuf, moved out of its internal string
+ *
+ * Writing resizes the string to its full capacity, so it is shrunk to the high mark.
+ * The stringbuf must be reset afterward.
+ */
+template<typename CharT>
+inline auto take_string(std::basic_stringbuf<CharT>& input) -> std::basic_string<CharT>
+{
+	std::basic_string<CharT>& str = get(StringbufTarget<CharT>{}, input);
+	const auto mode = get(ModeTarget<CharT>{}, input);
+
+	// See str()
+	if (mode & std::ios_base::out) {
+		CharT* high = get(HighMarkTarget<CharT>{}, input);
+		if (high < pptr(input)) {
+			high = pptr(input);
+		}
+		str.resize(static_cast<std::size_t>(high - pbase(input)));
+	} else if (!(mode & std::ios_base::in)) {
+		str.clear();
+	}
+
+	return std::move(str);
+}
+
+} // namespace bt::detail
+
+#endif // _LIBCPP_VERSION
+#endif // BUFFER_THIEF_SSTREAM_IMPLEMENTED
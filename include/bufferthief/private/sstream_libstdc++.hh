@@ -0,0 +1,81 @@
+/*
+ * sstream_libstdc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#include "common_sstream.hh"
+
+#if defined(__GLIBCXX__)
+#define BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#include "member_accessor.hh"
+
+#include <utility>
+
+namespace bt::detail {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-template-friend"
+
+template<typename CharT>
+struct StringbufTarget
+{
+	friend constexpr auto get(StringbufTarget, std::basic_stringbuf<CharT>&) -> std::basic_string<CharT>&;
+};
+
+#pragma GCC diagnostic pop
+
+template struct MemberAccessor<StringbufTarget<char>, &std::stringbuf::_M_string>;
+template struct MemberAccessor<StringbufTarget<wchar_t>, &std::wstringbuf::_M_string>;
+
+/**
+ * @returns contents of the stringbuf, moved out of its internal string
+ *
+ * Writing may have used the string's spare capacity without updating its length.
+ * The stringbuf must be reset afterward.
+ */
+template<typename CharT>
+inline auto take_string(std::basic_stringbuf<CharT>& input) -> std::basic_string<CharT>
+{
+	std::basic_string<CharT>& str = get(StringbufTarget<CharT>{}, input);
+
+	// See _M_high_mark()
+	CharT* high = pptr(input);
+	if (!high) {
+		// Not in output mode, so the string is the character sequence
+		return std::move(str);
+	}
+
+	if (CharT* end = egptr(input); end && end > high) {
+		high = end;
+	}
+
+	CharT* base = pbase(input);
+	const auto size = static_cast<std::size_t>(high - base);
+	if (base != str.data()) {
+		// An external buffer was provided with pubsetbuf()
+		str.assign(base, size);
+		return std::move(str);
+	}
+
+	// The put area never extends past the string's capacity, so the null terminator fits
+	get(LengthTarget<std::basic_string<CharT>>{}, str) = size;
+	base[size] = CharT();
+
+	return std::move(str);
+}
+
+} // namespace bt::detail
+
+#endif // __GLIBCXX__
+#endif // BUFFER_THIEF_SSTREAM_IMPLEMENTED
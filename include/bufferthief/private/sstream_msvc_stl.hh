@@ -0,0 +1,45 @@
+/*
+ * sstream_msvc_stl.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#include "common_sstream.hh"
+
+#if defined(_MSC_VER)
+#define BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#include <utility>
+
+namespace bt::detail {
+
+/**
+ * @returns contents of the stringbuf
+ *
+ * MSVC's stringbuf manages its own buffer rather than holding a std::basic_string,
+ * so its buffer can only be transferred by the C++20 rvalue str() overload.
+ * The stringbuf must be reset afterward.
+ */
+template<typename CharT>
+inline auto take_string(std::basic_stringbuf<CharT>& input) -> std::basic_string<CharT>
+{
+#if _HAS_CXX20
+	return std::move(input).str();
+#else
+	return input.str();
+#endif
+}
+
+} // namespace bt::detail
+
+#endif // _MSC_VER
+#endif // BUFFER_THIEF_SSTREAM_IMPLEMENTED
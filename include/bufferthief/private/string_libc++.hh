@@ -11,10 +11,23 @@
  * You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
-#ifndef BUFFER_THIEF_STRING_IMPLEMENTED
-
 #include "common_string.hh"
 
+// Defined outside the guard below, since <bufferthief/shm_allocator.hh> includes this header
+// again to instantiate it for its allocator. Undefined at the end of this header.
+#if defined(_LIBCPP_VERSION)
+#	define BT_STRING_ACCESSORS(Str) \
+	template struct StaticMemberAccessor<MinCapTarget<Str>, Str::__min_cap, std::size_t>; \
+	template struct StaticMemberAccessor<EndianFactorTarget<Str>, Str::__endian_factor, std::size_t>; \
+	template struct StaticMemberAccessor<IsLongTarget<Str>, &Str::__is_long>; \
+	template struct StaticMemberAccessor<SetShortSizeTarget<Str>, &Str::__set_short_size>; \
+	template struct StaticMemberAccessor<SetLongPointerTarget<Str>, &Str::__set_long_pointer>; \
+	template struct StaticMemberAccessor<SetLongCapTarget<Str>, &Str::__set_long_cap>; \
+	template struct StaticMemberAccessor<SetLongSizeTarget<Str>, &Str::__set_long_size>;
+#endif
+
+#if !defined(BUFFER_THIEF_STRING_IMPLEMENTED) && !defined(BUFFER_THIEF_SHM_ACCESSORS)
+
 #if defined(_LIBCPP_VERSION)
 #define BUFFER_THIEF_STRING_IMPLEMENTED
 
@@ -24,66 +37,95 @@
 
 namespace bt::detail {
 
-template<typename CharT>
+template<typename Str>
 struct MinCapTarget
 {
 	friend constexpr auto get(MinCapTarget) -> std::size_t;
 };
 
-template struct StaticMemberAccessor<MinCapTarget<char>, std::string::__min_cap, std::size_t>;
-template struct StaticMemberAccessor<MinCapTarget<wchar_t>, std::wstring::__min_cap, std::size_t>;
-#if defined(__cpp_lib_char8_t)
-template struct StaticMemberAccessor<MinCapTarget<char8_t>, std::u8string::__min_cap, std::size_t>;
-#endif
-template struct StaticMemberAccessor<MinCapTarget<char16_t>, std::u16string::__min_cap, std::size_t>;
-template struct StaticMemberAccessor<MinCapTarget<char32_t>, std::u32string::__min_cap, std::size_t>;
-
-//! Does not include null terminator
-template<typename CharT>
-constexpr auto small_string_max_size() noexcept -> std::size_t
+template<typename Str>
+struct EndianFactorTarget
 {
-	return get(MinCapTarget<CharT>{}) - 1;
-}
+	friend constexpr auto get(EndianFactorTarget) -> std::size_t;
+};
 
-template<typename CharT>
+template<typename Str>
 struct IsLongTarget
 {
-	friend constexpr auto get(IsLongTarget) -> bool(std::basic_string<CharT>::*)() const noexcept;
+	friend constexpr auto get(IsLongTarget) -> bool(Str::*)() const noexcept;
 };
 
-template struct StaticMemberAccessor<IsLongTarget<char>, &std::string::__is_long>;
-template struct StaticMemberAccessor<IsLongTarget<wchar_t>, &std::wstring::__is_long>;
-#if defined(__cpp_lib_char8_t)
-template struct StaticMemberAccessor<IsLongTarget<char8_t>, &std::u8string::__is_long>;
-#endif
-template struct StaticMemberAccessor<IsLongTarget<char16_t>, &std::u16string::__is_long>;
-template struct StaticMemberAccessor<IsLongTarget<char32_t>, &std::u32string::__is_long>;
+template<typename Str>
+struct SetShortSizeTarget
+{
+	using size_type = typename Str::size_type;
+	friend constexpr auto get(SetShortSizeTarget) -> void(Str::*)(size_type) noexcept;
+};
 
-template<typename CharT>
-BT_STRING_CONSTEXPR20 auto uses_large_buffer(const std::basic_string<CharT>& input) noexcept -> bool
+template<typename Str>
+struct SetLongPointerTarget
 {
-	return (input.*get(IsLongTarget<CharT>{}))();
-}
+	using pointer = typename Str::pointer;
+	friend constexpr auto get(SetLongPointerTarget) -> void(Str::*)(pointer) noexcept;
+};
 
-template<typename CharT>
-struct SetShortSizeTarget
+template<typename Str>
+struct SetLongCapTarget
+{
+	using size_type = typename Str::size_type;
+	friend constexpr auto get(SetLongCapTarget) -> void(Str::*)(size_type) noexcept;
+};
+
+template<typename Str>
+struct SetLongSizeTarget
 {
-	using size_type = std::basic_string<CharT>::size_type;
-	friend constexpr auto get(SetShortSizeTarget) -> void(std::basic_string<CharT>::*)(size_type) noexcept;
+	using size_type = typename Str::size_type;
+	friend constexpr auto get(SetLongSizeTarget) -> void(Str::*)(size_type) noexcept;
 };
 
-template struct StaticMemberAccessor<SetShortSizeTarget<char>, &std::string::__set_short_size>;
-template struct StaticMemberAccessor<SetShortSizeTarget<wchar_t>, &std::wstring::__set_short_size>;
+BT_STRING_ACCESSORS(std::string)
+BT_STRING_ACCESSORS(std::wstring)
 #if defined(__cpp_lib_char8_t)
-template struct StaticMemberAccessor<SetShortSizeTarget<char8_t>, &std::u8string::__set_short_size>;
+BT_STRING_ACCESSORS(std::u8string)
 #endif
-template struct StaticMemberAccessor<SetShortSizeTarget<char16_t>, &std::u16string::__set_short_size>;
-template struct StaticMemberAccessor<SetShortSizeTarget<char32_t>, &std::u32string::__set_short_size>;
+BT_STRING_ACCESSORS(std::u16string)
+BT_STRING_ACCESSORS(std::u32string)
 
+BT_STRING_ACCESSORS(bt::string)
+BT_STRING_ACCESSORS(bt::wstring)
+#if defined(__cpp_lib_char8_t)
+BT_STRING_ACCESSORS(bt::u8string)
+#endif
+BT_STRING_ACCESSORS(bt::u16string)
+BT_STRING_ACCESSORS(bt::u32string)
+
+#if defined(__cpp_lib_memory_resource)
+BT_STRING_ACCESSORS(std::pmr::string)
+BT_STRING_ACCESSORS(std::pmr::wstring)
+#	if defined(__cpp_lib_char8_t)
+BT_STRING_ACCESSORS(std::pmr::u8string)
+#	endif
+BT_STRING_ACCESSORS(std::pmr::u16string)
+BT_STRING_ACCESSORS(std::pmr::u32string)
+#endif
+
+//! Does not include null terminator. The same for every allocator.
 template<typename CharT>
-BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -> CharT*
+constexpr auto small_string_max_size() noexcept -> std::size_t
+{
+	return get(MinCapTarget<String<CharT>>{}) - 1;
+}
+
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto uses_large_buffer(const String<CharT, Alloc>& input) noexcept -> bool
+{
+	return (input.*get(IsLongTarget<String<CharT, Alloc>>{}))();
+}
+
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto try_steal(String<CharT, Alloc>& input) noexcept -> CharT*
 {
-	if (!uses_large_buffer<CharT>(input))
+	if (!uses_large_buffer(input))
 	{
 		// Small string
 		return nullptr;
@@ -92,7 +134,7 @@ BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -
 	CharT* ptr = input.data();
 
 	// Convert to small string
-	(input.*get(SetShortSizeTarget<CharT>{}))(0);
+	(input.*get(SetShortSizeTarget<String<CharT, Alloc>>{}))(0);
 
 	// Just in case
 	input.data()[0] = CharT();
@@ -102,7 +144,38 @@ BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -
 	return ptr;
 }
 
+//! `output` must be empty and not use a large buffer
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto try_adopt(String<CharT, Alloc>& output, CharT* ptr,
+	std::size_t size, std::size_t capacity) noexcept -> bool
+{
+	using Str = String<CharT, Alloc>;
+
+	// The long capacity is stored divided by the endian factor
+	if ((capacity + 1) % get(EndianFactorTarget<Str>{}) != 0) {
+		return false;
+	}
+
+	// Convert to large string
+	(output.*get(SetLongCapTarget<Str>{}))(capacity + 1);
+	(output.*get(SetLongPointerTarget<Str>{}))(ptr);
+	(output.*get(SetLongSizeTarget<Str>{}))(size);
+	ptr[size] = CharT();
+
+	return true;
+}
+
 } // namespace bt::detail
 
 #endif // _LIBCPP_VERSION
 #endif // BUFFER_THIEF_STRING_IMPLEMENTED
+
+// Opt-in hook for <bufferthief/shm_allocator.hh>, which includes this header again with
+// BUFFER_THIEF_SHM_ACCESSORS defined once its types are declared
+#if defined(_LIBCPP_VERSION) && defined(BUFFER_THIEF_SHM_ACCESSORS)
+namespace bt::detail {
+BT_STRING_ACCESSORS(bt::shm_string)
+} // namespace bt::detail
+#endif
+
+#undef BT_STRING_ACCESSORS
@@ -11,10 +11,20 @@
  * You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
-#ifndef BUFFER_THIEF_STRING_IMPLEMENTED
-
 #include "common_string.hh"
 
+// Defined outside the guard below, since <bufferthief/shm_allocator.hh> includes this header
+// again to instantiate it for its allocator. Undefined at the end of this header.
+#if defined(__GLIBCXX__)
+#	define BT_STRING_ACCESSORS(Str) \
+	template struct MemberAccessor<PointerTarget<Str>, &Str::_M_dataplus, &Str::_Alloc_hider::_M_p>; \
+	template struct MemberAccessor<LocalPointerTarget<Str>, &Str::_M_local_buf>; \
+	template struct MemberAccessor<LengthTarget<Str>, &Str::_M_string_length>; \
+	template struct MemberAccessor<CapacityTarget<Str>, &Str::_M_allocated_capacity>;
+#endif
+
+#if !defined(BUFFER_THIEF_STRING_IMPLEMENTED) && !defined(BUFFER_THIEF_SHM_ACCESSORS)
+
 #if defined(__GLIBCXX__)
 #define BUFFER_THIEF_STRING_IMPLEMENTED
 
@@ -36,46 +46,74 @@ constexpr auto small_string_max_size() noexcept -> std::size_t
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wnon-template-friend"
 
-template<typename CharT>
+template<typename Str>
 struct PointerTarget
 {
-	friend constexpr auto get(PointerTarget, std::basic_string<CharT>&) -> CharT*&;
-	friend constexpr auto get(PointerTarget, const std::basic_string<CharT>&) -> CharT* const&;
+	using CharT = typename Str::value_type;
+	friend constexpr auto get(PointerTarget, Str&) -> CharT*&;
+	friend constexpr auto get(PointerTarget, const Str&) -> CharT* const&;
 };
 
-template<typename CharT>
+template<typename Str>
 struct LocalPointerTarget
 {
+	using CharT = typename Str::value_type;
 	using Type = CharT(&)[small_string_max_size<CharT>() + 1];
 	using ConstType = const CharT(&)[small_string_max_size<CharT>() + 1];
 
-	friend constexpr auto get(LocalPointerTarget, std::basic_string<CharT>&) -> Type;
-	friend constexpr auto get(LocalPointerTarget, const std::basic_string<CharT>&) -> ConstType;
+	friend constexpr auto get(LocalPointerTarget, Str&) -> Type;
+	friend constexpr auto get(LocalPointerTarget, const Str&) -> ConstType;
+};
+
+template<typename Str>
+struct LengthTarget
+{
+	using size_type = typename Str::size_type;
+	friend constexpr auto get(LengthTarget, Str&) -> size_type&;
+};
+
+template<typename Str>
+struct CapacityTarget
+{
+	using size_type = typename Str::size_type;
+	friend constexpr auto get(CapacityTarget, Str&) -> size_type&;
 };
 
 #pragma GCC diagnostic pop
 
-template struct MemberAccessor<PointerTarget<char>, &std::string::_M_dataplus, &std::string::_Alloc_hider::_M_p>;
-template struct MemberAccessor<PointerTarget<wchar_t>, &std::wstring::_M_dataplus, &std::wstring::_Alloc_hider::_M_p>;
+BT_STRING_ACCESSORS(std::string)
+BT_STRING_ACCESSORS(std::wstring)
 #if defined(__cpp_lib_char8_t)
-template struct MemberAccessor<PointerTarget<char8_t>, &std::u8string::_M_dataplus, &std::u8string::_Alloc_hider::_M_p>;
+BT_STRING_ACCESSORS(std::u8string)
 #endif
-template struct MemberAccessor<PointerTarget<char16_t>, &std::u16string::_M_dataplus, &std::u16string::_Alloc_hider::_M_p>;
-template struct MemberAccessor<PointerTarget<char32_t>, &std::u32string::_M_dataplus, &std::u32string::_Alloc_hider::_M_p>;
+BT_STRING_ACCESSORS(std::u16string)
+BT_STRING_ACCESSORS(std::u32string)
 
-template struct MemberAccessor<LocalPointerTarget<char>, &std::string::_M_local_buf>;
-template struct MemberAccessor<LocalPointerTarget<wchar_t>, &std::wstring::_M_local_buf>;
+BT_STRING_ACCESSORS(bt::string)
+BT_STRING_ACCESSORS(bt::wstring)
 #if defined(__cpp_lib_char8_t)
-template struct MemberAccessor<LocalPointerTarget<char8_t>, &std::u8string::_M_local_buf>;
+BT_STRING_ACCESSORS(bt::u8string)
+#endif
+BT_STRING_ACCESSORS(bt::u16string)
+BT_STRING_ACCESSORS(bt::u32string)
+
+#if defined(__cpp_lib_memory_resource)
+BT_STRING_ACCESSORS(std::pmr::string)
+BT_STRING_ACCESSORS(std::pmr::wstring)
+#	if defined(__cpp_lib_char8_t)
+BT_STRING_ACCESSORS(std::pmr::u8string)
+#	endif
+BT_STRING_ACCESSORS(std::pmr::u16string)
+BT_STRING_ACCESSORS(std::pmr::u32string)
 #endif
-template struct MemberAccessor<LocalPointerTarget<char16_t>, &std::u16string::_M_local_buf>;
-template struct MemberAccessor<LocalPointerTarget<char32_t>, &std::u32string::_M_local_buf>;
 
-template<typename CharT>
-BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -> CharT*
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto try_steal(String<CharT, Alloc>& input) noexcept -> CharT*
 {
-	CharT*& internal_ptr = get(PointerTarget<CharT>{}, input);
-	CharT* local_buffer_ptr = get(LocalPointerTarget<CharT>{}, input);
+	using Str = String<CharT, Alloc>;
+
+	CharT*& internal_ptr = get(PointerTarget<Str>{}, input);
+	CharT* local_buffer_ptr = get(LocalPointerTarget<Str>{}, input);
 
 	if (internal_ptr == local_buffer_ptr) {
 		// Small string
@@ -91,15 +129,42 @@ BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -
 	return ptr;
 }
 
-template<typename CharT>
-BT_STRING_CONSTEXPR20 auto uses_large_buffer(const std::basic_string<CharT>& input) noexcept -> bool
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto uses_large_buffer(const String<CharT, Alloc>& input) noexcept -> bool
 {
-	const CharT* internal_ptr = get(PointerTarget<CharT>{}, input);
-	const CharT* local_buffer_ptr = get(LocalPointerTarget<CharT>{}, input);
+	using Str = String<CharT, Alloc>;
+
+	const CharT* internal_ptr = get(PointerTarget<Str>{}, input);
+	const CharT* local_buffer_ptr = get(LocalPointerTarget<Str>{}, input);
 	return internal_ptr != local_buffer_ptr;
 }
 
+//! `output` must be empty and not use a large buffer
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto try_adopt(String<CharT, Alloc>& output, CharT* ptr,
+	std::size_t size, std::size_t capacity) noexcept -> bool
+{
+	using Str = String<CharT, Alloc>;
+
+	get(PointerTarget<Str>{}, output) = ptr; // convert to large string
+	get(CapacityTarget<Str>{}, output) = capacity;
+	get(LengthTarget<Str>{}, output) = size;
+	ptr[size] = CharT();
+
+	return true;
+}
+
 } // namespace bt::detail
 
 #endif // __GLIBCXX__
 #endif // BUFFER_THIEF_STRING_IMPLEMENTED
+
+// Opt-in hook for <bufferthief/shm_allocator.hh>, which includes this header again with
+// BUFFER_THIEF_SHM_ACCESSORS defined once its types are declared
+#if defined(__GLIBCXX__) && defined(BUFFER_THIEF_SHM_ACCESSORS)
+namespace bt::detail {
+BT_STRING_ACCESSORS(bt::shm_string)
+} // namespace bt::detail
+#endif
+
+#undef BT_STRING_ACCESSORS
@@ -22,38 +22,59 @@
 
 namespace bt::detail {
 
-template<typename CharT>
+template<typename Str>
 struct Target
 {
-	using Alloc = std::_Rebind_alloc_t<typename std::basic_string<CharT>::allocator_type, CharT>;
+	using CharT = typename Str::value_type;
+	using Alloc = std::_Rebind_alloc_t<typename Str::allocator_type, CharT>;
+	static_assert(std::_Is_simple_alloc_v<Alloc>);
+
 	using Data = std::_String_val<std::_Simple_types<CharT>>;
 	using Member = std::_Compressed_pair<Alloc, Data>;
 
-	friend constexpr auto get(Target, std::basic_string<CharT>&) -> Member&;
+	friend constexpr auto get(Target, Str&) -> Member&;
 };
 
-template struct MemberAccessor<Target<char>, &std::string::_Mypair>;
-template struct MemberAccessor<Target<wchar_t>, &std::wstring::_Mypair>;
+template struct MemberAccessor<Target<std::string>, &std::string::_Mypair>;
+template struct MemberAccessor<Target<std::wstring>, &std::wstring::_Mypair>;
 #if defined(__cpp_lib_char8_t)
-template struct MemberAccessor<Target<char8_t>, &std::u8string::_Mypair>;
+template struct MemberAccessor<Target<std::u8string>, &std::u8string::_Mypair>;
+#endif
+template struct MemberAccessor<Target<std::u16string>, &std::u16string::_Mypair>;
+template struct MemberAccessor<Target<std::u32string>, &std::u32string::_Mypair>;
+
+template struct MemberAccessor<Target<bt::string>, &bt::string::_Mypair>;
+template struct MemberAccessor<Target<bt::wstring>, &bt::wstring::_Mypair>;
+#if defined(__cpp_lib_char8_t)
+template struct MemberAccessor<Target<bt::u8string>, &bt::u8string::_Mypair>;
+#endif
+template struct MemberAccessor<Target<bt::u16string>, &bt::u16string::_Mypair>;
+template struct MemberAccessor<Target<bt::u32string>, &bt::u32string::_Mypair>;
+
+#if defined(__cpp_lib_memory_resource)
+template struct MemberAccessor<Target<std::pmr::string>, &std::pmr::string::_Mypair>;
+template struct MemberAccessor<Target<std::pmr::wstring>, &std::pmr::wstring::_Mypair>;
+#	if defined(__cpp_lib_char8_t)
+template struct MemberAccessor<Target<std::pmr::u8string>, &std::pmr::u8string::_Mypair>;
+#	endif
+template struct MemberAccessor<Target<std::pmr::u16string>, &std::pmr::u16string::_Mypair>;
+template struct MemberAccessor<Target<std::pmr::u32string>, &std::pmr::u32string::_Mypair>;
 #endif
-template struct MemberAccessor<Target<char16_t>, &std::u16string::_Mypair>;
-template struct MemberAccessor<Target<char32_t>, &std::u32string::_Mypair>;
 
 //! Does not include null terminator
 template<typename CharT>
 constexpr auto small_string_max_size() noexcept -> std::size_t
 {
-	return Target<CharT>::Data::_BUF_SIZE - 1;
+	return Target<String<CharT>>::Data::_BUF_SIZE - 1;
 }
 
-template<typename CharT>
-BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -> CharT*
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto try_steal(String<CharT, Alloc>& input) noexcept -> CharT*
 {
-	using Data = Target<CharT>::Data;
-	using Member = Target<CharT>::Member;
+	using Data = typename Target<String<CharT, Alloc>>::Data;
+	using Member = typename Target<String<CharT, Alloc>>::Member;
 
-	Member& internal = get(Target<CharT>{}, input);
+	Member& internal = get(Target<String<CharT, Alloc>>{}, input);
 	Data& data = internal._Myval2;
 
 	// See _Large_mode_engaged() or _Large_string_engaged()
@@ -74,10 +95,32 @@ BT_STRING_CONSTEXPR20 auto try_steal(std::basic_string<CharT>& input) noexcept -
 	return ptr;
 }
 
-template<typename CharT>
-BT_STRING_CONSTEXPR20 auto uses_large_buffer(const std::basic_string<CharT>& input) noexcept -> bool
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto uses_large_buffer(const String<CharT, Alloc>& input) noexcept -> bool
 {
-	return input.capacity() >= Target<CharT>::Data::_BUF_SIZE;
+	return input.capacity() >= Target<String<CharT, Alloc>>::Data::_BUF_SIZE;
+}
+
+//! `output` must be empty and not use a large buffer
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto try_adopt(String<CharT, Alloc>& output, CharT* ptr,
+	std::size_t size, std::size_t capacity) noexcept -> bool
+{
+	using Data = typename Target<String<CharT, Alloc>>::Data;
+
+	Data& data = get(Target<String<CharT, Alloc>>{}, output)._Myval2;
+
+	// See _Large_mode_engaged() or _Large_string_engaged()
+	if (capacity < Data::_BUF_SIZE) {
+		return false;
+	}
+
+	std::_Construct_in_place(data._Bx._Ptr, ptr); // convert to large string
+	data._Myres = capacity;
+	data._Mysize = size;
+	ptr[size] = CharT();
+
+	return true;
 }
 
 } // namespace bt::detail
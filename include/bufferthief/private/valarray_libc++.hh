@@ -0,0 +1,105 @@
+/*
+ * valarray_libc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_VALARRAY_IMPLEMENTED
+
+#include "common_valarray.hh"
+
+#if defined(_LIBCPP_VERSION)
+#define BUFFER_THIEF_VALARRAY_IMPLEMENTED
+
+#if _LIBCPP_VERSION < 15000
+#	error "libc++ 15 or newer is required"
+#endif
+
+#include "member_accessor.hh"
+
+namespace bt::detail {
+
+/**
+ * As with std::vector, the member offsets are taken from this instantiation and
+ * applied to std::valarray<T>, which has the same layout for every T.
+ */
+using ValarrayProbe = std::valarray<unsigned char>;
+
+template<typename Probe>
+struct ValarrayBeginTarget
+{
+	friend constexpr auto get(ValarrayBeginTarget, Probe&) -> unsigned char*&;
+};
+
+template<typename Probe>
+struct ValarrayEndTarget
+{
+	friend constexpr auto get(ValarrayEndTarget, Probe&) -> unsigned char*&;
+};
+
+template struct MemberAccessor<ValarrayBeginTarget<ValarrayProbe>, &ValarrayProbe::__begin_>;
+template struct MemberAccessor<ValarrayEndTarget<ValarrayProbe>, &ValarrayProbe::__end_>;
+
+struct ValarrayLayout
+{
+	std::size_t begin;
+	std::size_t end;
+};
+
+//! @returns byte offsets of the members within std::valarray<T>, measured on a probe the first time
+inline auto valarray_layout() noexcept -> const ValarrayLayout&
+{
+	// The begin and end pointers
+	static_assert(sizeof(ValarrayProbe) == 2 * sizeof(unsigned char*),
+		"Unexpected std::valarray layout");
+
+	static const ValarrayLayout layout = [] {
+		ValarrayProbe probe;
+
+		auto offset = [&](unsigned char** member) -> std::size_t {
+			return reinterpret_cast<unsigned char*>(member) - reinterpret_cast<unsigned char*>(&probe);
+		};
+
+		return ValarrayLayout{
+			offset(&get(ValarrayBeginTarget<ValarrayProbe>{}, probe)),
+			offset(&get(ValarrayEndTarget<ValarrayProbe>{}, probe))
+		};
+	}();
+
+	return layout;
+}
+
+/**
+ * @returns internal buffer of the valarray, which holds exactly size() elements
+ *
+ * The buffer is allocated with std::allocator<T>.
+ */
+template<typename T>
+inline auto steal(std::valarray<T>& input) noexcept -> T*
+{
+	static_assert(sizeof(std::valarray<T>) == sizeof(ValarrayProbe), "std::valarray layout depends on T");
+
+	const ValarrayLayout& layout = valarray_layout();
+	auto* bytes = reinterpret_cast<unsigned char*>(&input);
+
+	auto& begin = *reinterpret_cast<T**>(bytes + layout.begin);
+	auto& end = *reinterpret_cast<T**>(bytes + layout.end);
+
+	T* ptr = begin;
+	begin = nullptr;
+	end = nullptr;
+
+	return ptr;
+}
+
+} // namespace bt::detail
+
+#endif // _LIBCPP_VERSION
+#endif // BUFFER_THIEF_VALARRAY_IMPLEMENTED
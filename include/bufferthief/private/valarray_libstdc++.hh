@@ -0,0 +1,109 @@
+/*
+ * valarray_libstdc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_VALARRAY_IMPLEMENTED
+
+#include "common_valarray.hh"
+
+#if defined(__GLIBCXX__)
+#define BUFFER_THIEF_VALARRAY_IMPLEMENTED
+
+#include "member_accessor.hh"
+
+namespace bt::detail {
+
+/**
+ * Private members can only be accessed through an explicit instantiation, which is
+ * not possible for every T. Since std::valarray<T> has the same layout for every T,
+ * the member offsets are taken from this instantiation and applied to std::valarray<T>.
+ */
+using ValarrayProbe = std::valarray<unsigned char>;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-template-friend"
+
+template<typename Probe>
+struct ValarraySizeTarget
+{
+	friend constexpr auto get(ValarraySizeTarget, Probe&) -> std::size_t&;
+};
+
+template<typename Probe>
+struct ValarrayDataTarget
+{
+	friend constexpr auto get(ValarrayDataTarget, Probe&) -> unsigned char* __restrict__&;
+};
+
+#pragma GCC diagnostic pop
+
+template struct MemberAccessor<ValarraySizeTarget<ValarrayProbe>, &ValarrayProbe::_M_size>;
+template struct MemberAccessor<ValarrayDataTarget<ValarrayProbe>, &ValarrayProbe::_M_data>;
+
+struct ValarrayLayout
+{
+	std::size_t size;
+	std::size_t data;
+};
+
+//! @returns byte offsets of the members within std::valarray<T>, measured on a probe the first time
+inline auto valarray_layout() noexcept -> const ValarrayLayout&
+{
+	// The size, then the data pointer
+	static_assert(sizeof(ValarrayProbe) == sizeof(std::size_t) + sizeof(unsigned char*),
+		"Unexpected std::valarray layout");
+
+	static const ValarrayLayout layout = [] {
+		ValarrayProbe probe;
+
+		auto offset = [&](void* member) -> std::size_t {
+			return static_cast<unsigned char*>(member) - reinterpret_cast<unsigned char*>(&probe);
+		};
+
+		return ValarrayLayout{
+			offset(&get(ValarraySizeTarget<ValarrayProbe>{}, probe)),
+			offset(&get(ValarrayDataTarget<ValarrayProbe>{}, probe))
+		};
+	}();
+
+	return layout;
+}
+
+/**
+ * @returns internal buffer of the valarray, which holds exactly size() elements
+ *
+ * The buffer is allocated with operator new, so it may be deallocated by std::allocator<T>.
+ */
+template<typename T>
+inline auto steal(std::valarray<T>& input) noexcept -> T*
+{
+	static_assert(sizeof(std::valarray<T>) == sizeof(ValarrayProbe), "std::valarray layout depends on T");
+	static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+		"Over-aligned types are allocated without their alignment");
+
+	const ValarrayLayout& layout = valarray_layout();
+	auto* bytes = reinterpret_cast<unsigned char*>(&input);
+
+	auto& size = *reinterpret_cast<std::size_t*>(bytes + layout.size);
+	auto& data = *reinterpret_cast<T**>(bytes + layout.data);
+
+	T* ptr = data;
+	size = 0;
+	data = nullptr;
+
+	return ptr;
+}
+
+} // namespace bt::detail
+
+#endif // __GLIBCXX__
+#endif // BUFFER_THIEF_VALARRAY_IMPLEMENTED
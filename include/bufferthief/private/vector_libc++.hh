@@ -0,0 +1,179 @@
+/*
+ * vector_libc++.hh
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "common_vector.hh"
+
+// Defined outside the guard below, since <bufferthief/shm_allocator.hh> includes this header
+// again to instantiate it for its allocator. Undefined at the end of this header.
+#if defined(_LIBCPP_VERSION)
+#	if _LIBCPP_VERSION >= 200000
+#		define BT_VECTOR_ACCESSORS(Probe) \
+	template struct MemberAccessor<BeginTarget<Probe>, &Probe::__begin_>; \
+	template struct MemberAccessor<EndTarget<Probe>, &Probe::__end_>; \
+	template struct MemberAccessor<CapTarget<Probe>, &Probe::__cap_>;
+#	else
+#		define BT_VECTOR_ACCESSORS(Probe) \
+	template struct MemberAccessor<BeginTarget<Probe>, &Probe::__begin_>; \
+	template struct MemberAccessor<EndTarget<Probe>, &Probe::__end_>; \
+	template struct MemberAccessor<CapTarget<Probe>, &Probe::__end_cap_>;
+#	endif
+#endif
+
+#if !defined(BUFFER_THIEF_VECTOR_IMPLEMENTED) && !defined(BUFFER_THIEF_SHM_ACCESSORS)
+
+#if defined(_LIBCPP_VERSION)
+#define BUFFER_THIEF_VECTOR_IMPLEMENTED
+
+#if _LIBCPP_VERSION < 15000
+#	error "libc++ 15 or newer is required"
+#endif
+
+#include "member_accessor.hh"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace bt::detail {
+
+/**
+ * Private members can only be accessed through an explicit instantiation, which is
+ * not possible for every T. Since std::vector<T, Alloc> has the same layout for every T,
+ * the member offsets are taken from this instantiation and applied to std::vector<T, Alloc>.
+ */
+template<typename Alloc>
+using VectorProbe = std::vector<unsigned char, typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char>>;
+
+template<typename Probe>
+struct BeginTarget
+{
+	friend constexpr auto get(BeginTarget, Probe&) -> unsigned char*&;
+};
+
+template<typename Probe>
+struct EndTarget
+{
+	friend constexpr auto get(EndTarget, Probe&) -> unsigned char*&;
+};
+
+template<typename Probe>
+struct CapTarget
+{
+#if _LIBCPP_VERSION >= 200000
+	using Member = unsigned char*;
+#else
+	using Member = std::__compressed_pair<unsigned char*, typename Probe::allocator_type>;
+#endif
+
+	friend constexpr auto get(CapTarget, Probe&) -> Member&;
+};
+
+BT_VECTOR_ACCESSORS(std::vector<unsigned char>)
+BT_VECTOR_ACCESSORS(bt::vector<unsigned char>)
+#if defined(__cpp_lib_memory_resource)
+BT_VECTOR_ACCESSORS(std::pmr::vector<unsigned char>)
+#endif
+
+struct VectorLayout
+{
+	std::size_t begin;
+	std::size_t end;
+	std::size_t cap;
+};
+
+/**
+ * @returns byte offsets of the pointer members within std::vector<T, Alloc>
+ *
+ * They are measured on a probe the first time, since the members cannot be named in offsetof.
+ */
+template<typename Alloc>
+inline auto vector_layout() noexcept -> const VectorLayout&
+{
+	using Probe = VectorProbe<Alloc>;
+	using ProbeAlloc = typename Probe::allocator_type;
+
+	// Three pointers, with the allocator stored alongside the capacity unless it is empty
+	static_assert(sizeof(Probe) == 3 * sizeof(unsigned char*) + (std::is_empty_v<ProbeAlloc> ? 0 : sizeof(ProbeAlloc)),
+		"Unexpected std::vector layout");
+
+	static const VectorLayout layout = [] {
+		Probe probe;
+
+		auto offset = [&](unsigned char** member) -> std::size_t {
+			return reinterpret_cast<unsigned char*>(member) - reinterpret_cast<unsigned char*>(&probe);
+		};
+
+#if _LIBCPP_VERSION >= 200000
+		unsigned char** cap = &get(CapTarget<Probe>{}, probe);
+#else
+		unsigned char** cap = &get(CapTarget<Probe>{}, probe).first();
+#endif
+
+		return VectorLayout{
+			offset(&get(BeginTarget<Probe>{}, probe)),
+			offset(&get(EndTarget<Probe>{}, probe)),
+			offset(cap)
+		};
+	}();
+
+	return layout;
+}
+
+template<typename T, typename Alloc>
+inline auto pointer_member(std::vector<T, Alloc>& input, std::size_t offset) noexcept -> T*&
+{
+	static_assert(sizeof(std::vector<T, Alloc>) == sizeof(VectorProbe<Alloc>), "std::vector layout depends on T");
+	static_assert(alignof(std::vector<T, Alloc>) == alignof(VectorProbe<Alloc>), "std::vector layout depends on T");
+	static_assert(sizeof(T*) == sizeof(unsigned char*));
+
+	return *reinterpret_cast<T**>(reinterpret_cast<unsigned char*>(&input) + offset);
+}
+
+template<typename T, typename Alloc>
+inline auto steal(std::vector<T, Alloc>& input) noexcept -> T*
+{
+	const VectorLayout& layout = vector_layout<Alloc>();
+
+	T* ptr = pointer_member(input, layout.begin);
+
+	pointer_member(input, layout.begin) = nullptr;
+	pointer_member(input, layout.end) = nullptr;
+	pointer_member(input, layout.cap) = nullptr;
+
+	return ptr;
+}
+
+//! `output` must be empty and have no buffer
+template<typename T, typename Alloc>
+inline void adopt(std::vector<T, Alloc>& output, T* ptr, std::size_t size, std::size_t capacity) noexcept
+{
+	const VectorLayout& layout = vector_layout<Alloc>();
+
+	pointer_member(output, layout.begin) = ptr;
+	pointer_member(output, layout.end) = ptr + size;
+	pointer_member(output, layout.cap) = ptr + capacity;
+}
+
+} // namespace bt::detail
+
+#endif // _LIBCPP_VERSION
+#endif // BUFFER_THIEF_VECTOR_IMPLEMENTED
+
+// Opt-in hook for <bufferthief/shm_allocator.hh>, which includes this header again with
+// BUFFER_THIEF_SHM_ACCESSORS defined once its types are declared
+#if defined(_LIBCPP_VERSION) && defined(BUFFER_THIEF_SHM_ACCESSORS)
+namespace bt::detail {
+BT_VECTOR_ACCESSORS(bt::shm_vector<unsigned char>)
+} // namespace bt::detail
+#endif
+
+#undef BT_VECTOR_ACCESSORS
@@ -22,20 +22,24 @@
 
 namespace bt::detail {
 
-template<typename T>
-BT_VECTOR_CONSTEXPR20 auto steal(std::vector<T>& input) noexcept -> T*
+template<typename T, typename Alloc>
+BT_VECTOR_CONSTEXPR20 auto get_impl(std::vector<T, Alloc>& input) noexcept
+	-> typename std::_Vector_base<T, Alloc>::_Vector_impl&
 {
-	using Base = std::_Vector_base<T, std::allocator<T>>;
-	using Impl = Base::_Vector_impl;
+	using Base = std::_Vector_base<T, Alloc>;
 
-#if defined(__cpp_lib_is_pointer_interconvertible) && __cpp_lib_is_pointer_interconvertible >= 201907L
-	static_assert(std::is_pointer_interconvertible_base_of_v<Base, std::vector<T>>);
-#else
-	static_assert(std::is_base_of_v<Base, std::vector<T>>);
-#endif
+	static_assert(std::is_base_of_v<Base, std::vector<T, Alloc>>);
 
-	// C-style cast allows converting derived class to inaccessible base class
-	Impl& impl = ((Base&)input)._M_impl;
+	// C-style cast allows converting derived class to inaccessible base class.
+	// It adjusts the pointer like static_cast, so the base need not be at offset 0,
+	// which it may not be for stateful allocators.
+	return ((Base&)input)._M_impl;
+}
+
+template<typename T, typename Alloc>
+BT_VECTOR_CONSTEXPR20 auto steal(std::vector<T, Alloc>& input) noexcept -> T*
+{
+	auto& impl = get_impl(input);
 
 	T* ptr = impl._M_start;
 
@@ -46,6 +50,17 @@ BT_VECTOR_CONSTEXPR20 auto steal(std::vector<T>& input) noexcept -> T*
 	return ptr;
 }
 
+//! `output` must be empty and have no buffer
+template<typename T, typename Alloc>
+BT_VECTOR_CONSTEXPR20 void adopt(std::vector<T, Alloc>& output, T* ptr, std::size_t size, std::size_t capacity) noexcept
+{
+	auto& impl = get_impl(output);
+
+	impl._M_start = ptr;
+	impl._M_finish = ptr + size;
+	impl._M_end_of_storage = ptr + capacity;
+}
+
 } // namespace bt::detail
 
 #endif // __GLIBCXX__
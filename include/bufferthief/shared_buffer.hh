@@ -0,0 +1,223 @@
+/*
+ * shared_buffer.hh - Reference-counted stolen buffers, with the count stored in spare capacity
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SHARED_BUFFER_H
+#define BUFFER_THIEF_SHARED_BUFFER_H
+
+#include "buffer.hh"
+#include "string.hh"
+#include "vector.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bt {
+
+namespace detail {
+
+//! Reference count and deallocation details, placed after the contents when they leave enough room
+struct SharedControl
+{
+	std::atomic<std::size_t> references;
+	std::size_t capacity;
+	bool separate; //!< allocated on its own instead of in the buffer's spare capacity
+};
+
+} // namespace detail
+
+/**
+ * @brief Read-only buffer shared by several owners, like std::shared_ptr.
+ *
+ * The reference count is stored in the buffer's spare capacity when it fits, so sharing a
+ * stolen buffer usually costs no allocation. Otherwise, it is allocated separately.
+ * Copies may be used and destroyed on any thread. The last owner destroys the elements and
+ * deallocates the buffer.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class shared_buffer
+{
+	static_assert(std::allocator_traits<Allocator>::is_always_equal::value
+		&& std::is_default_constructible_v<Allocator>, "Stateful allocators are not supported");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+
+	shared_buffer() noexcept = default;
+
+	shared_buffer(const shared_buffer& other) noexcept
+		: data_{other.data_}
+		, size_{other.size_}
+		, control_{other.control_}
+	{
+		if (control_) {
+			control_->references.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	shared_buffer(shared_buffer&& other) noexcept
+		: data_{std::exchange(other.data_, nullptr)}
+		, size_{std::exchange(other.size_, 0)}
+		, control_{std::exchange(other.control_, nullptr)}
+	{}
+
+	auto operator=(const shared_buffer& other) noexcept -> shared_buffer&
+	{
+		shared_buffer{other}.swap(*this);
+		return *this;
+	}
+
+	auto operator=(shared_buffer&& other) noexcept -> shared_buffer&
+	{
+		shared_buffer{std::move(other)}.swap(*this);
+		return *this;
+	}
+
+	~shared_buffer()
+	{
+		reset();
+	}
+
+	auto data() const noexcept -> const T* { return data_; }
+	auto get() const noexcept -> const T* { return data_; }
+	auto size() const noexcept -> size_type { return size_; }
+	auto empty() const noexcept -> bool { return size_ == 0; }
+
+	auto begin() const noexcept -> const T* { return data_; }
+	auto end() const noexcept -> const T* { return data_ + size_; }
+
+	auto operator[](size_type index) const noexcept -> const T& { return data_[index]; }
+
+	explicit operator bool() const noexcept { return data_ != nullptr; }
+
+	//! Number of owners, which may be out of date by the time it is used
+	auto use_count() const noexcept -> size_type
+	{
+		return control_ ? control_->references.load(std::memory_order_relaxed) : 0;
+	}
+
+	//! Whether the reference count is stored in the buffer's spare capacity
+	auto shares_storage() const noexcept -> bool { return control_ && !control_->separate; }
+
+	//! Gives up ownership, releasing the buffer if this was the last owner
+	void reset() noexcept
+	{
+		if (control_ && control_->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			const auto capacity = control_->capacity;
+
+			if (control_->separate) {
+				std::allocator<detail::SharedControl>{}.deallocate(control_, 1);
+			} else {
+				control_->~SharedControl();
+			}
+
+			std::destroy_n(data_, size_);
+			Allocator alloc;
+			std::allocator_traits<Allocator>::deallocate(alloc, data_, capacity);
+		}
+
+		data_ = nullptr;
+		size_ = 0;
+		control_ = nullptr;
+	}
+
+	void swap(shared_buffer& other) noexcept
+	{
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(control_, other.control_);
+	}
+
+	friend auto operator==(const shared_buffer& lhs, std::nullptr_t) noexcept -> bool { return !lhs; }
+	friend auto operator==(std::nullptr_t, const shared_buffer& rhs) noexcept -> bool { return !rhs; }
+	friend auto operator!=(const shared_buffer& lhs, std::nullptr_t) noexcept -> bool { return !!lhs; }
+	friend auto operator!=(std::nullptr_t, const shared_buffer& rhs) noexcept -> bool { return !!rhs; }
+
+	/**
+	 * @brief Shares the buffer's contents, which must not be modified afterward.
+	 *
+	 * The reference count is placed after the first `used` elements when the rest of the
+	 * capacity has room for it. `used` is at least the buffer's size, and covers elements
+	 * past the end which must be kept, such as a string's null terminator.
+	 */
+	static auto make(buffer<T, Allocator>&& input, size_type used) -> shared_buffer
+	{
+		shared_buffer result;
+		if (!input) { return result; }
+
+		const auto capacity = input.capacity();
+		auto* bytes = reinterpret_cast<unsigned char*>(input.data());
+
+		// First suitably aligned address after the used elements
+		const auto offset = used * sizeof(T);
+		const auto address = reinterpret_cast<std::uintptr_t>(bytes + offset);
+		const auto padding = (alignof(detail::SharedControl) - address % alignof(detail::SharedControl))
+			% alignof(detail::SharedControl);
+
+		if (offset + padding + sizeof(detail::SharedControl) <= capacity * sizeof(T)) {
+			result.control_ = ::new (static_cast<void*>(bytes + offset + padding)) detail::SharedControl{{1}, capacity, false};
+		} else {
+			auto* control = std::allocator<detail::SharedControl>{}.allocate(1);
+			result.control_ = ::new (static_cast<void*>(control)) detail::SharedControl{{1}, capacity, true};
+		}
+
+		result.size_ = input.size();
+		result.data_ = input.release();
+		return result;
+	}
+
+private:
+	T* data_ = nullptr;
+	size_type size_ = 0;
+	detail::SharedControl* control_ = nullptr;
+};
+
+/**
+ * @returns shared ownership of the buffer's contents
+ * @see shared_buffer::make()
+ */
+template<typename T, typename Alloc>
+auto steal_shared(buffer<T, Alloc>&& input) -> shared_buffer<T, Alloc>
+{
+	const auto size = input.size();
+	return shared_buffer<T, Alloc>::make(std::move(input), size);
+}
+
+/**
+ * @returns shared ownership of the string's contents, stealing its buffer when possible
+ *
+ * The contents remain null-terminated.
+ */
+template<typename CharT, typename Alloc>
+auto steal_shared(std::basic_string<CharT, std::char_traits<CharT>, Alloc>&& input) -> shared_buffer<CharT, Alloc>
+{
+	auto stolen = bt::steal(std::move(input));
+	const auto size = stolen.size();
+	return shared_buffer<CharT, Alloc>::make(std::move(stolen), size + 1);
+}
+
+//! @returns shared ownership of the vector's contents
+template<typename T, typename Alloc>
+auto steal_shared(std::vector<T, Alloc>&& input) -> shared_buffer<T, Alloc>
+{
+	return bt::steal_shared(bt::steal(std::move(input)));
+}
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_SHARED_BUFFER_H
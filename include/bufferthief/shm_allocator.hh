@@ -0,0 +1,567 @@
+/*
+ * shm_allocator.hh - Allocator whose buffers live in shared memory and can be handed to another process
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SHM_ALLOCATOR_H
+#define BUFFER_THIEF_SHM_ALLOCATOR_H
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define BUFFER_THIEF_SHM_AVAILABLE
+
+#include "buffer.hh"
+#include "string.hh"
+#include "vector.hh"
+#include "private/common_allocator.hh"
+
+// libc++ accesses each container through accessors instantiated for its allocator, so these
+// must be included before the accessors for shm_allocator are instantiated below
+#if defined(_LIBCPP_VERSION) && !defined(BT_COPY_BUFFERS)
+#	include "bit_vector.hh"
+#	include "deque.hh"
+#endif
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bt {
+
+/**
+ * @brief Location of a buffer within a shared memory arena, which may be sent to another process.
+ *
+ * Standard-layout and trivially copyable, so it can be written to a pipe or socket as is.
+ */
+struct shm_handle
+{
+	//! Identifies the arena's segment. See shm_arena::attach().
+	std::uint64_t segment;
+
+	//! Byte offset of the data from the start of the segment
+	std::uint64_t offset;
+
+	//! Bytes of data, not including a string's null terminator
+	std::uint64_t length;
+
+	//! Bytes allocated, which are returned to the arena by shm_arena::release()
+	std::uint64_t capacity;
+};
+
+namespace detail {
+
+//! Placed at the start of each segment. Every process which maps it shares this state.
+struct ShmArenaHeader
+{
+	static constexpr std::uint64_t magic_value = 0x62742d73686d3031; // "bt-shm01"
+
+	std::uint64_t magic;
+	std::uint64_t segment_size;
+	std::uint64_t data_offset;
+	std::uint64_t granules;
+	std::uint64_t used;   //!< bytes allocated, guarded by `mutex`
+	std::uint64_t hint;   //!< granule where the next search starts, guarded by `mutex`
+	::pthread_mutex_t mutex; //!< process-shared, and robust where supported
+};
+
+} // namespace detail
+
+/**
+ * @brief Fixed-size arena in a POSIX shared memory segment.
+ *
+ * The creating process allocates from it through shm_allocator. Other processes attach
+ * to the segment by its id, read the buffers they are handed, and release them back to
+ * the arena when they are done. The allocation bitmap and its mutex live in the segment,
+ * so any attached process may release.
+ *
+ * Allocations are rounded up to `granularity` bytes and found by a first-fit search of
+ * the bitmap, which suits a modest number of large buffers.
+ *
+ * The bitmap is guarded by a robust mutex, so a process which dies while holding it does
+ * not block the others. Any allocation that process was making is lost. macOS has no robust
+ * mutexes, so there a process dying during allocate() or release() deadlocks the arena.
+ */
+class shm_arena
+{
+public:
+	//! Allocation unit and alignment, in bytes
+	static constexpr std::size_t granularity = 64;
+
+	/**
+	 * @brief Creates a segment with room for `capacity` bytes of allocations.
+	 * The segment is removed when this arena is destroyed, though existing mappings remain valid.
+	 * @throws std::system_error if the segment cannot be created
+	 */
+	explicit shm_arena(std::size_t capacity)
+		: segment_{next_segment_id()}
+		, owner_{true}
+	{
+		const auto granules = (capacity + granularity - 1) / granularity;
+		const auto bitmap_words = (granules + 63) / 64;
+		const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+		const auto data_offset = round_up(sizeof(detail::ShmArenaHeader) + bitmap_words * sizeof(std::uint64_t), page);
+		size_ = data_offset + granules * granularity;
+
+		const auto name = segment_name(segment_);
+		const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (fd < 0) { throw std::system_error{errno, std::generic_category(), "shm_open"}; }
+
+		if (::ftruncate(fd, static_cast<::off_t>(size_)) != 0) {
+			const int error = errno;
+			::close(fd);
+			::shm_unlink(name.c_str());
+			throw std::system_error{error, std::generic_category(), "ftruncate"};
+		}
+
+		map(fd, name);
+
+		// The new segment is zero-filled, so the bitmap starts out free
+		auto* header = ::new (base_) detail::ShmArenaHeader{};
+		header->segment_size = size_;
+		header->data_offset = data_offset;
+		header->granules = granules;
+		try {
+			init_mutex(header->mutex);
+		} catch (...) {
+			::munmap(base_, size_);
+			::shm_unlink(name.c_str());
+			throw;
+		}
+
+		// Attaching processes check this last, once the header is complete
+		header->magic = detail::ShmArenaHeader::magic_value;
+	}
+
+	/**
+	 * @brief Maps the segment of an arena created by another process.
+	 * @throws std::system_error if the segment does not exist or is not an arena
+	 */
+	static auto attach(std::uint64_t segment) -> shm_arena
+	{
+		shm_arena arena;
+		arena.segment_ = segment;
+
+		const auto name = segment_name(segment);
+		const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+		if (fd < 0) { throw std::system_error{errno, std::generic_category(), "shm_open"}; }
+
+		struct ::stat info;
+		if (::fstat(fd, &info) != 0) {
+			const int error = errno;
+			::close(fd);
+			throw std::system_error{error, std::generic_category(), "fstat"};
+		}
+		arena.size_ = static_cast<std::size_t>(info.st_size);
+
+		if (arena.size_ < sizeof(detail::ShmArenaHeader)) {
+			::close(fd);
+			throw std::system_error{EINVAL, std::generic_category(), "shm_arena::attach"};
+		}
+
+		arena.map(fd, name);
+		if (arena.header().magic != detail::ShmArenaHeader::magic_value) {
+			throw std::system_error{EINVAL, std::generic_category(), "shm_arena::attach"};
+		}
+
+		return arena;
+	}
+
+	shm_arena(shm_arena&& other) noexcept
+		: base_{std::exchange(other.base_, nullptr)}
+		, size_{std::exchange(other.size_, 0)}
+		, segment_{std::exchange(other.segment_, 0)}
+		, owner_{std::exchange(other.owner_, false)}
+	{}
+
+	auto operator=(shm_arena&& other) noexcept -> shm_arena&
+	{
+		shm_arena{std::move(other)}.swap(*this);
+		return *this;
+	}
+
+	shm_arena(const shm_arena&) = delete;
+	auto operator=(const shm_arena&) -> shm_arena& = delete;
+
+	~shm_arena()
+	{
+		if (base_) {
+			::munmap(base_, size_);
+		}
+		if (owner_) {
+			::shm_unlink(segment_name(segment_).c_str());
+		}
+	}
+
+	void swap(shm_arena& other) noexcept
+	{
+		std::swap(base_, other.base_);
+		std::swap(size_, other.size_);
+		std::swap(segment_, other.segment_);
+		std::swap(owner_, other.owner_);
+	}
+
+	auto segment() const noexcept -> std::uint64_t { return segment_; }
+
+	//! Bytes available for allocations
+	auto capacity() const noexcept -> std::size_t
+	{
+		return static_cast<std::size_t>(header().granules) * granularity;
+	}
+
+	//! Bytes currently allocated by any process, which may be out of date by the time it is used
+	auto used() const noexcept -> std::size_t
+	{
+		Lock lock{header()};
+		return static_cast<std::size_t>(header().used);
+	}
+
+	/**
+	 * @returns `bytes` of storage aligned to `granularity`
+	 * @throws std::bad_alloc if the arena has no free range large enough
+	 */
+	auto allocate(std::size_t bytes) -> void*
+	{
+		const auto count = granules_for(bytes);
+		auto& h = header();
+
+		Lock lock{h};
+		auto first = find_free(h.hint, count);
+		if (first == h.granules) { first = find_free(0, count); }
+		if (first == h.granules) { throw std::bad_alloc{}; }
+
+		mark(first, count, true);
+		h.used += count * granularity;
+		h.hint = first + count;
+
+		return base_ + h.data_offset + first * granularity;
+	}
+
+	//! Returns storage from allocate() to the arena
+	void deallocate(void* p, std::size_t bytes) noexcept
+	{
+		const auto offset = static_cast<std::size_t>(static_cast<unsigned char*>(p) - base_);
+		free_range(offset, granules_for(bytes));
+	}
+
+	//! @returns handle to `length` bytes at `p`, within an allocation of `capacity` bytes
+	auto handle(const void* p, std::size_t length, std::size_t capacity) const noexcept -> shm_handle
+	{
+		if (!p) { return shm_handle{segment_, 0, 0, 0}; }
+
+		const auto offset = static_cast<const unsigned char*>(p) - base_;
+		return shm_handle{segment_, static_cast<std::uint64_t>(offset), length, capacity};
+	}
+
+	//! @returns the handle's data in this process, or nullptr if it is empty
+	auto data(const shm_handle& handle) const noexcept -> void*
+	{
+		return handle.capacity > 0 ? base_ + handle.offset : nullptr;
+	}
+
+	//! Returns the handle's storage to the arena. Must be called once, by any attached process.
+	void release(const shm_handle& handle) noexcept
+	{
+		if (handle.capacity == 0) { return; }
+		free_range(static_cast<std::size_t>(handle.offset), granules_for(static_cast<std::size_t>(handle.capacity)));
+	}
+
+private:
+	//! Holds the segment's mutex, which is never held for longer than a bitmap search
+	class Lock
+	{
+	public:
+		explicit Lock(detail::ShmArenaHeader& header) noexcept
+			: mutex_{header.mutex}
+		{
+			[[maybe_unused]] const int result = ::pthread_mutex_lock(&mutex_);
+#if !defined(__APPLE__)
+			// The previous owner died while holding it. Its allocation may be leaked, but the bitmap is still usable.
+			if (result == EOWNERDEAD) {
+				::pthread_mutex_consistent(&mutex_);
+			}
+#endif
+		}
+
+		Lock(const Lock&) = delete;
+		auto operator=(const Lock&) -> Lock& = delete;
+
+		~Lock()
+		{
+			::pthread_mutex_unlock(&mutex_);
+		}
+
+	private:
+		::pthread_mutex_t& mutex_;
+	};
+
+	shm_arena() = default;
+
+	/**
+	 * Other processes may still use the mutex after the creator is gone, so it is never
+	 * destroyed. It is freed along with the segment.
+	 */
+	static void init_mutex(::pthread_mutex_t& mutex)
+	{
+		::pthread_mutexattr_t attr;
+		int result = ::pthread_mutexattr_init(&attr);
+		if (result == 0) {
+			result = ::pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+		}
+#if !defined(__APPLE__)
+		if (result == 0) {
+			result = ::pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+		}
+#endif
+		if (result == 0) {
+			result = ::pthread_mutex_init(&mutex, &attr);
+		}
+		::pthread_mutexattr_destroy(&attr);
+
+		if (result != 0) {
+			throw std::system_error{result, std::generic_category(), "pthread_mutex_init"};
+		}
+	}
+
+	static auto round_up(std::size_t value, std::size_t multiple) noexcept -> std::size_t
+	{
+		return (value + multiple - 1) / multiple * multiple;
+	}
+
+	static auto granules_for(std::size_t bytes) noexcept -> std::size_t
+	{
+		return bytes > 0 ? (bytes + granularity - 1) / granularity : 1;
+	}
+
+	static auto next_segment_id() noexcept -> std::uint64_t
+	{
+		static std::atomic<std::uint32_t> counter{0};
+		const auto pid = static_cast<std::uint64_t>(::getpid());
+		return (pid << 32) | counter.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static auto segment_name(std::uint64_t segment) -> std::string
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "/bt-shm-%016llx", static_cast<unsigned long long>(segment));
+		return name;
+	}
+
+	//! Maps and closes `fd`
+	void map(int fd, const std::string& name)
+	{
+		void* base = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		const int error = errno;
+		::close(fd);
+
+		if (base == MAP_FAILED) {
+			if (owner_) { ::shm_unlink(name.c_str()); }
+			throw std::system_error{error, std::generic_category(), "mmap"};
+		}
+
+		base_ = static_cast<unsigned char*>(base);
+	}
+
+	auto header() const noexcept -> detail::ShmArenaHeader&
+	{
+		return *std::launder(reinterpret_cast<detail::ShmArenaHeader*>(base_));
+	}
+
+	auto bitmap() const noexcept -> std::uint64_t*
+	{
+		return reinterpret_cast<std::uint64_t*>(base_ + sizeof(detail::ShmArenaHeader));
+	}
+
+	//! @returns first granule of `count` free granules at or after `start`, or the number of granules if there are none
+	auto find_free(std::uint64_t start, std::size_t count) const noexcept -> std::uint64_t
+	{
+		const auto granules = header().granules;
+		const auto* words = bitmap();
+
+		std::uint64_t run = 0;
+		std::uint64_t first = 0;
+		for (auto i = start; i < granules; ++i) {
+			// Skip words which are fully allocated
+			if (i % 64 == 0 && words[i / 64] == ~std::uint64_t{0}) {
+				run = 0;
+				i += 63;
+				continue;
+			}
+
+			if (words[i / 64] & (std::uint64_t{1} << (i % 64))) {
+				run = 0;
+				continue;
+			}
+
+			if (run++ == 0) { first = i; }
+			if (run == count) { return first; }
+		}
+		return granules;
+	}
+
+	void mark(std::uint64_t first, std::size_t count, bool allocated) noexcept
+	{
+		auto* words = bitmap();
+		for (auto i = first; i < first + count; ++i) {
+			const auto bit = std::uint64_t{1} << (i % 64);
+			if (allocated) {
+				words[i / 64] |= bit;
+			} else {
+				words[i / 64] &= ~bit;
+			}
+		}
+	}
+
+	void free_range(std::size_t offset, std::size_t count) noexcept
+	{
+		auto& h = header();
+		const auto first = (offset - h.data_offset) / granularity;
+
+		Lock lock{h};
+		mark(first, count, false);
+		h.used -= count * granularity;
+		if (first < h.hint) { h.hint = first; }
+	}
+
+	unsigned char* base_ = nullptr;
+	std::size_t size_ = 0;
+	std::uint64_t segment_ = 0;
+	bool owner_ = false; //!< whether this process created the segment and removes it
+};
+
+/**
+ * @brief Allocator which allocates from a shm_arena.
+ *
+ * Buffers stolen from containers which use it can be handed to another process with
+ * to_shm_handle(). A default-constructed allocator has no arena and cannot allocate.
+ */
+template<typename T>
+class shm_allocator
+{
+	static_assert(alignof(T) <= shm_arena::granularity, "Over-aligned types are not supported");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	shm_allocator() noexcept = default;
+
+	shm_allocator(shm_arena& arena) noexcept
+		: arena_{&arena}
+	{}
+
+	template<typename U>
+	shm_allocator(const shm_allocator<U>& other) noexcept
+		: arena_{other.arena()}
+	{}
+
+	auto allocate(std::size_t n) -> T*
+	{
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length{};
+		}
+		if (!arena_) { throw std::bad_alloc{}; }
+
+		return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		arena_->deallocate(p, n * sizeof(T));
+	}
+
+	auto arena() const noexcept -> shm_arena* { return arena_; }
+
+	template<typename U>
+	friend auto operator==(const shm_allocator& lhs, const shm_allocator<U>& rhs) noexcept -> bool
+	{
+		return lhs.arena() == rhs.arena();
+	}
+
+	template<typename U>
+	friend auto operator!=(const shm_allocator& lhs, const shm_allocator<U>& rhs) noexcept -> bool
+	{
+		return lhs.arena() != rhs.arena();
+	}
+
+private:
+	shm_arena* arena_ = nullptr;
+};
+
+//! String whose buffer is allocated in a shared memory arena
+using shm_string = std::basic_string<char, std::char_traits<char>, shm_allocator<char>>;
+
+//! Vector whose buffer is allocated in a shared memory arena
+template<typename T>
+using shm_vector = std::vector<T, shm_allocator<T>>;
+
+namespace detail {
+
+template<typename T> struct SupportedAllocator<shm_allocator<T>> { static constexpr bool value = true; };
+
+} // namespace detail
+
+/**
+ * @returns handle to the buffer, which another process may read and must release
+ *
+ * The buffer no longer owns its storage, and its elements are not destroyed, so they
+ * should be trivially copyable. A string's null terminator is included in the capacity.
+ */
+template<typename T>
+auto to_shm_handle(buffer<T, shm_allocator<T>>&& input) noexcept -> shm_handle
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Elements must be trivially copyable");
+
+	if (!input) { return shm_handle{}; }
+
+	const auto length = input.size() * sizeof(T);
+	const auto capacity = input.capacity() * sizeof(T);
+	shm_arena* arena = input.get_allocator().arena();
+
+	return arena->handle(input.release(), length, capacity);
+}
+
+} // namespace bt
+
+// Instantiates each container's accessors for shm_allocator through the hook at the end of its private header
+#if !defined(BT_COPY_BUFFERS)
+#	define BUFFER_THIEF_SHM_ACCESSORS
+#	include "private/string_libc++.hh"
+#	include "private/string_libstdc++.hh"
+#	include "private/vector_libc++.hh"
+#	if defined(_LIBCPP_VERSION)
+#		include "private/bit_vector_libc++.hh"
+#		include "private/deque_libc++.hh"
+#	endif
+#	undef BUFFER_THIEF_SHM_ACCESSORS
+#endif
+
+#endif // __has_include(<sys/mman.h>) ...
+
+#endif // BUFFER_THIEF_SHM_ALLOCATOR_H
@@ -0,0 +1,354 @@
+/*
+ * slab.hh - Per-thread slab allocator for copies of small strings
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SLAB_H
+#define BUFFER_THIEF_SLAB_H
+
+#include "buffer.hh"
+#include "string.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#if !defined(BT_COPY_BUFFERS)
+
+namespace bt {
+
+namespace detail {
+
+//! Pages are aligned to their size, so a block's page is found by masking its address
+inline constexpr std::size_t slab_page_size = std::size_t{1} << 16;
+
+struct SlabBlock
+{
+	SlabBlock* next;
+};
+
+/**
+ * @brief Header at the start of each page.
+ *
+ * Only the owning thread allocates from a page. Blocks freed by the owner go on `local_free`,
+ * while blocks freed by other threads are pushed onto `remote_free`, which the owner takes
+ * all at once when it runs out of blocks.
+ *
+ * `outstanding` starts at the number of blocks in the page and is only decremented after
+ * the owner exits, which detaches the page by swapping `remote_free` for a sentinel and
+ * subtracting the blocks it still held. Whoever brings it to zero frees the page.
+ */
+struct SlabPage
+{
+	std::uint64_t owner;
+	SlabPage* next_page;
+	SlabBlock* local_free;
+	std::byte* bump;
+	std::byte* end;
+	std::atomic<SlabBlock*> remote_free;
+	std::atomic<std::size_t> outstanding;
+};
+
+inline SlabBlock slab_detached_sentinel{};
+
+inline auto slab_detached() noexcept -> SlabBlock*
+{
+	return &slab_detached_sentinel;
+}
+
+inline auto slab_page_of(void* ptr) noexcept -> SlabPage*
+{
+	return reinterpret_cast<SlabPage*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(slab_page_size - 1));
+}
+
+inline void free_slab_page(SlabPage* page) noexcept
+{
+	page->~SlabPage();
+	::operator delete(static_cast<void*>(page), std::align_val_t{slab_page_size});
+}
+
+//! Owner of pages made for single blocks after a thread's cache is detached, which no thread has
+inline constexpr std::uint64_t slab_orphan_owner = ~std::uint64_t{0};
+
+//! Never returns 0, which means a thread has not allocated yet, or slab_orphan_owner
+inline auto next_slab_owner() noexcept -> std::uint64_t
+{
+	static std::atomic<std::uint64_t> counter{0};
+	return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+//! Fixed-size block allocator with a cache of pages per thread
+template<std::size_t BlockSize>
+class Slab
+{
+	static_assert(BlockSize >= sizeof(SlabBlock) && BlockSize % alignof(SlabBlock) == 0);
+
+	static constexpr std::size_t header_size =
+		(sizeof(SlabPage) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+	static constexpr std::size_t blocks_per_page = (slab_page_size - header_size) / BlockSize;
+
+	//! Trivially destructible, so it remains usable while other thread_local objects are destroyed
+	struct Cache
+	{
+		std::uint64_t id = 0;
+		SlabPage* pages = nullptr;
+		SlabPage* current = nullptr;
+		bool dead = false;
+	};
+
+	//! Detaches the thread's pages when the thread exits
+	struct Guard
+	{
+		~Guard() { detach(cache()); }
+	};
+
+public:
+	static auto allocate() -> void*
+	{
+		Cache& c = cache();
+		if (c.dead) {
+			return allocate_orphan();
+		}
+
+		if (c.current) {
+			if (void* ptr = take(c.current)) { return ptr; }
+
+			for (SlabPage* page = c.pages; page; page = page->next_page) {
+				if (void* ptr = take(page)) {
+					c.current = page;
+					return ptr;
+				}
+			}
+		}
+
+		c.current = new_page(c);
+		return take(c.current);
+	}
+
+	static void deallocate(void* ptr) noexcept
+	{
+		SlabPage* page = slab_page_of(ptr);
+		auto* block = static_cast<SlabBlock*>(ptr);
+
+		if (const Cache& c = cache(); page->owner == c.id && !c.dead) {
+			block->next = page->local_free;
+			page->local_free = block;
+			return;
+		}
+
+		SlabBlock* head = page->remote_free.load(std::memory_order_relaxed);
+		do {
+			if (head == slab_detached()) {
+				if (page->outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					free_slab_page(page);
+				}
+				return;
+			}
+			block->next = head;
+		} while (!page->remote_free.compare_exchange_weak(head, block,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+private:
+	static auto cache() noexcept -> Cache&
+	{
+		static thread_local Cache c;
+		return c;
+	}
+
+	static auto take(SlabPage* page) noexcept -> void*
+	{
+		if (SlabBlock* block = page->local_free) {
+			page->local_free = block->next;
+			return block;
+		}
+
+		if (page->end - page->bump >= static_cast<std::ptrdiff_t>(BlockSize)) {
+			void* ptr = page->bump;
+			page->bump += BlockSize;
+			return ptr;
+		}
+
+		if (SlabBlock* block = page->remote_free.exchange(nullptr, std::memory_order_acquire)) {
+			page->local_free = block->next;
+			return block;
+		}
+
+		return nullptr;
+	}
+
+	static auto create_page(std::uint64_t owner) -> SlabPage*
+	{
+		void* memory = ::operator new(slab_page_size, std::align_val_t{slab_page_size});
+		auto* first = static_cast<std::byte*>(memory) + header_size;
+
+		return ::new (memory) SlabPage{owner, nullptr, nullptr, first, first + blocks_per_page * BlockSize,
+			{nullptr}, {blocks_per_page}};
+	}
+
+	static auto new_page(Cache& c) -> SlabPage*
+	{
+		static thread_local Guard guard;
+		(void)guard;
+
+		if (c.id == 0) {
+			c.id = next_slab_owner();
+		}
+
+		SlabPage* page = create_page(c.id);
+		page->next_page = c.pages;
+		c.pages = page;
+		return page;
+	}
+
+	//! After the thread's cache is detached, each block gets a page which is freed along with it
+	static auto allocate_orphan() -> void*
+	{
+		SlabPage* page = create_page(slab_orphan_owner);
+		void* ptr = take(page);
+		page->remote_free.store(slab_detached(), std::memory_order_relaxed);
+		page->outstanding.store(1, std::memory_order_release);
+		return ptr;
+	}
+
+	static auto count(SlabBlock* block) noexcept -> std::size_t
+	{
+		std::size_t result = 0;
+		for (; block; block = block->next) { ++result; }
+		return result;
+	}
+
+	static void detach(Cache& c) noexcept
+	{
+		c.dead = true;
+
+		for (SlabPage* page = c.pages; page;) {
+			SlabPage* next = page->next_page;
+
+			SlabBlock* remote = page->remote_free.exchange(slab_detached(), std::memory_order_acq_rel);
+			const auto held = static_cast<std::size_t>(page->end - page->bump) / BlockSize
+				+ count(page->local_free) + count(remote);
+
+			if (page->outstanding.fetch_sub(held, std::memory_order_acq_rel) == held) {
+				free_slab_page(page);
+			}
+
+			page = next;
+		}
+
+		c.pages = nullptr;
+		c.current = nullptr;
+	}
+};
+
+} // namespace detail
+
+/**
+ * @brief Allocator for copies of small strings, backed by a per-thread slab.
+ *
+ * Allocations of exactly `slot_size` characters come from the calling thread's slab, and
+ * may be deallocated on any thread. All other sizes are forwarded to std::allocator, so
+ * buffers stolen from strings can share this allocator with copies of small strings.
+ */
+template<typename CharT>
+class slab_allocator
+{
+public:
+	using value_type = CharT;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_move_assignment = std::true_type;
+	using is_always_equal = std::true_type;
+
+	//! Characters in a small string, including the null terminator
+	static constexpr std::size_t slot_size = detail::small_string_max_size<CharT>() + 1;
+
+	constexpr slab_allocator() noexcept = default;
+
+	template<typename U>
+	constexpr slab_allocator(const slab_allocator<U>&) noexcept {}
+
+	auto allocate(std::size_t n) -> CharT*
+	{
+		if (n == slot_size) {
+			return static_cast<CharT*>(Slab::allocate());
+		}
+		return std::allocator<CharT>{}.allocate(n);
+	}
+
+	void deallocate(CharT* p, std::size_t n) noexcept
+	{
+		if (n == slot_size) {
+			Slab::deallocate(p);
+			return;
+		}
+		std::allocator<CharT>{}.deallocate(p, n);
+	}
+
+	template<typename U>
+	friend constexpr auto operator==(const slab_allocator&, const slab_allocator<U>&) noexcept -> bool { return true; }
+
+	template<typename U>
+	friend constexpr auto operator!=(const slab_allocator&, const slab_allocator<U>&) noexcept -> bool { return false; }
+
+private:
+	static constexpr std::size_t block_size =
+		(slot_size * sizeof(CharT) + alignof(detail::SlabBlock) - 1) / alignof(detail::SlabBlock) * alignof(detail::SlabBlock);
+
+	using Slab = detail::Slab<block_size>;
+};
+
+//! Tag for stealing with small strings copied into slab_allocator storage
+struct use_slab_t
+{
+	explicit use_slab_t() = default;
+};
+
+inline constexpr use_slab_t use_slab{};
+
+/**
+ * @returns string contents, stealing the internal buffer when possible and copying small strings into a slab
+ *
+ * The buffer's capacity() includes the null terminator. Stolen buffers have more than
+ * slab_allocator<CharT>::slot_size characters, so they are deallocated with std::allocator.
+ */
+template<typename CharT>
+auto steal(std::basic_string<CharT>&& input, use_slab_t) -> buffer<CharT, slab_allocator<CharT>>
+{
+	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+
+	using Alloc = slab_allocator<CharT>;
+
+	const auto size = input.size();
+	const auto capacity = input.capacity() + 1;
+
+	if (CharT* ptr = detail::try_steal(input)) {
+		detail::record_steal(detail::StatsKind::string, (size + 1) * sizeof(CharT));
+		return buffer<CharT, Alloc>{ptr, size, capacity};
+	}
+
+	// Copy the small string, including the null terminator
+	buffer<CharT, Alloc> copy{Alloc{}.allocate(Alloc::slot_size), 0, Alloc::slot_size};
+	std::char_traits<CharT>::copy(copy.data(), input.c_str(), size + 1);
+	copy.commit(size);
+
+	detail::record_copy(detail::StatsKind::string, (size + 1) * sizeof(CharT));
+	return copy;
+}
+
+} // namespace bt
+
+#endif // !BT_COPY_BUFFERS
+
+#endif // BUFFER_THIEF_SLAB_H
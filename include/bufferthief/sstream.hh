@@ -0,0 +1,73 @@
+/*
+ * sstream.hh - Utility for stealing the internal buffer of std::basic_stringbuf
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_SSTREAM_H
+#define BUFFER_THIEF_SSTREAM_H
+
+#include "buffer.hh"
+#include "string.hh"
+#include "private/common_sstream.hh"
+
+#undef BUFFER_THIEF_SSTREAM_IMPLEMENTED
+#if !defined(BT_COPY_BUFFERS)
+#	include "private/sstream_libc++.hh"
+#	include "private/sstream_libstdc++.hh"
+#	include "private/sstream_msvc_stl.hh"
+#	if !defined(BUFFER_THIEF_SSTREAM_IMPLEMENTED)
+#		error "No supported C++ Standard Library implementation detected"
+#	endif
+#endif
+
+namespace bt {
+
+/**
+ * @returns contents of the stringbuf, as returned by str(), stealing its buffer when possible
+ *
+ * The buffer's capacity() includes the null terminator. The stringbuf is left empty and
+ * keeps its open mode, so it may be written to again.
+ */
+template<typename CharT>
+auto steal(std::basic_stringbuf<CharT>&& input) -> buffer<CharT>
+{
+	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+
+#if !defined(BT_COPY_BUFFERS)
+	auto contents = bt::steal(detail::take_string(input));
+#else
+	auto contents = bt::steal(input.str());
+#endif
+
+	input.str(std::basic_string<CharT>{});
+
+	return contents;
+}
+
+//! @returns contents of the stream's stringbuf, stealing its buffer when possible
+template<typename CharT>
+auto steal(std::basic_ostringstream<CharT>&& input) -> buffer<CharT>
+{
+	return bt::steal(std::move(*input.rdbuf()));
+}
+
+//! @returns contents of the stream's stringbuf, stealing its buffer when possible
+template<typename CharT>
+auto steal(std::basic_stringstream<CharT>&& input) -> buffer<CharT>
+{
+	return bt::steal(std::move(*input.rdbuf()));
+}
+
+} // namespace bt
+
+#undef BUFFER_THIEF_SSTREAM_IMPLEMENTED
+
+#endif // BUFFER_THIEF_SSTREAM_H
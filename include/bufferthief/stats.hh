@@ -0,0 +1,203 @@
+/*
+ * stats.hh - Optional counters for how often buffers are stolen or copied
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_STATS_H
+#define BUFFER_THIEF_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__cpp_lib_is_constant_evaluated)
+#	define BT_STATS_CONSTEXPR constexpr
+#else
+#	define BT_STATS_CONSTEXPR inline
+#endif
+
+namespace bt {
+
+//! Totals of every counter at one point in time
+struct stats_snapshot
+{
+	//! Number of size classes. Class `i > 0` holds sizes in [2^(i-1), 2^i) bytes, and class 0 holds empty buffers.
+	static constexpr std::size_t size_classes = 65;
+
+	std::uint64_t string_steals = 0;
+	std::uint64_t string_copies = 0;
+	std::uint64_t vector_steals = 0;
+	std::uint64_t vector_copies = 0;
+
+	//! Bytes handed over without copying. For strings this includes the null terminator.
+	std::uint64_t bytes_stolen = 0;
+
+	//! Bytes copied because a buffer could not or should not be stolen
+	std::uint64_t bytes_copied = 0;
+
+	std::array<std::uint64_t, size_classes> stolen_sizes{};
+	std::array<std::uint64_t, size_classes> copied_sizes{};
+};
+
+namespace detail {
+
+enum class StatsKind { string, vector };
+
+//! @returns size class of `bytes`, which is its bit width
+constexpr auto stats_size_class(std::size_t bytes) noexcept -> std::size_t
+{
+	std::size_t result = 0;
+	for (; bytes != 0; bytes >>= 1) { ++result; }
+	return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Process-wide steal and copy counters, updated only when BT_ENABLE_STATS is defined.
+ *
+ * Counters are split into shards, and each thread updates one shard with relaxed atomics so
+ * threads rarely share a cache line. snapshot() sums the shards, so it may be slightly behind
+ * operations running on other threads.
+ */
+class steal_stats
+{
+public:
+	static constexpr std::size_t shard_count = 32;
+
+	auto snapshot() const noexcept -> stats_snapshot
+	{
+		stats_snapshot result;
+		for (const auto& shard : shards_) {
+			result.string_steals += load(shard.string_steals);
+			result.string_copies += load(shard.string_copies);
+			result.vector_steals += load(shard.vector_steals);
+			result.vector_copies += load(shard.vector_copies);
+			result.bytes_stolen += load(shard.bytes_stolen);
+			result.bytes_copied += load(shard.bytes_copied);
+			for (std::size_t i = 0; i < stats_snapshot::size_classes; ++i) {
+				result.stolen_sizes[i] += load(shard.stolen_sizes[i]);
+				result.copied_sizes[i] += load(shard.copied_sizes[i]);
+			}
+		}
+		return result;
+	}
+
+	//! Sets every counter to zero. Operations running concurrently may or may not be counted.
+	void reset() noexcept
+	{
+		for (auto& shard : shards_) {
+			clear(shard.string_steals);
+			clear(shard.string_copies);
+			clear(shard.vector_steals);
+			clear(shard.vector_copies);
+			clear(shard.bytes_stolen);
+			clear(shard.bytes_copied);
+			for (std::size_t i = 0; i < stats_snapshot::size_classes; ++i) {
+				clear(shard.stolen_sizes[i]);
+				clear(shard.copied_sizes[i]);
+			}
+		}
+	}
+
+	void record_steal(detail::StatsKind kind, std::size_t bytes) noexcept
+	{
+		auto& shard = local_shard();
+		add(kind == detail::StatsKind::string ? shard.string_steals : shard.vector_steals, 1);
+		add(shard.bytes_stolen, bytes);
+		add(shard.stolen_sizes[detail::stats_size_class(bytes)], 1);
+	}
+
+	void record_copy(detail::StatsKind kind, std::size_t bytes) noexcept
+	{
+		auto& shard = local_shard();
+		add(kind == detail::StatsKind::string ? shard.string_copies : shard.vector_copies, 1);
+		add(shard.bytes_copied, bytes);
+		add(shard.copied_sizes[detail::stats_size_class(bytes)], 1);
+	}
+
+private:
+	using Counter = std::atomic<std::uint64_t>;
+
+	struct alignas(64) Shard
+	{
+		Counter string_steals{0};
+		Counter string_copies{0};
+		Counter vector_steals{0};
+		Counter vector_copies{0};
+		Counter bytes_stolen{0};
+		Counter bytes_copied{0};
+		Counter stolen_sizes[stats_snapshot::size_classes]{};
+		Counter copied_sizes[stats_snapshot::size_classes]{};
+	};
+
+	static auto load(const Counter& counter) noexcept -> std::uint64_t
+	{
+		return counter.load(std::memory_order_relaxed);
+	}
+
+	static void clear(Counter& counter) noexcept
+	{
+		counter.store(0, std::memory_order_relaxed);
+	}
+
+	//! Threads beyond shard_count share shards, so updates must still be atomic
+	static void add(Counter& counter, std::uint64_t value) noexcept
+	{
+		counter.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	auto local_shard() noexcept -> Shard&
+	{
+		static std::atomic<std::size_t> next_shard{0};
+		static thread_local const std::size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+		return shards_[index];
+	}
+
+	Shard shards_[shard_count];
+};
+
+//! @returns the process-wide counters
+inline auto stats() noexcept -> steal_stats&
+{
+	static steal_stats instance;
+	return instance;
+}
+
+namespace detail {
+
+BT_STATS_CONSTEXPR void record_steal([[maybe_unused]] StatsKind kind, [[maybe_unused]] std::size_t bytes) noexcept
+{
+#if defined(BT_ENABLE_STATS)
+#	if defined(__cpp_lib_is_constant_evaluated)
+	if (std::is_constant_evaluated()) { return; }
+#	endif
+	bt::stats().record_steal(kind, bytes);
+#endif
+}
+
+BT_STATS_CONSTEXPR void record_copy([[maybe_unused]] StatsKind kind, [[maybe_unused]] std::size_t bytes) noexcept
+{
+#if defined(BT_ENABLE_STATS)
+#	if defined(__cpp_lib_is_constant_evaluated)
+	if (std::is_constant_evaluated()) { return; }
+#	endif
+	bt::stats().record_copy(kind, bytes);
+#endif
+}
+
+} // namespace detail
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_STATS_H
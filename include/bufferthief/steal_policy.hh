@@ -0,0 +1,65 @@
+/*
+ * steal_policy.hh - Policies for choosing between stealing a buffer and copying it
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_STEAL_POLICY_H
+#define BUFFER_THIEF_STEAL_POLICY_H
+
+#include <cstddef>
+#include <type_traits>
+
+namespace bt {
+
+/*
+ * A steal policy is called with the bytes a buffer uses and the bytes it has allocated,
+ * and returns true to steal the buffer or false to make a tight copy instead.
+ * Any callable with that signature may be used as a policy.
+ */
+
+//! Always steals, which is what bt::steal() does without a policy
+struct always_steal
+{
+	constexpr auto operator()(std::size_t, std::size_t) const noexcept -> bool { return true; }
+};
+
+//! Copies when the unused fraction of the buffer's capacity is more than `ratio`
+struct copy_if_slack_exceeds_ratio
+{
+	double ratio = 0.5;
+
+	constexpr auto operator()(std::size_t used, std::size_t capacity) const noexcept -> bool
+	{
+		return static_cast<double>(capacity - used) <= ratio * static_cast<double>(capacity);
+	}
+};
+
+//! Copies when the buffer's unused capacity is more than `bytes`
+struct copy_if_slack_exceeds_bytes
+{
+	std::size_t bytes = 4096;
+
+	constexpr auto operator()(std::size_t used, std::size_t capacity) const noexcept -> bool
+	{
+		return capacity - used <= bytes;
+	}
+};
+
+namespace detail {
+
+template<typename Policy>
+using EnableIfStealPolicy = std::enable_if_t<std::is_invocable_r_v<bool, const Policy&, std::size_t, std::size_t>, int>;
+
+} // namespace detail
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_STEAL_POLICY_H
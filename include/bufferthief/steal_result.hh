@@ -0,0 +1,106 @@
+/*
+ * steal_result.hh - Fixed-layout result of stealing a string, with inline storage for small strings
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_STEAL_RESULT_H
+#define BUFFER_THIEF_STEAL_RESULT_H
+
+#include "string.hh"
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#if !defined(BT_COPY_BUFFERS)
+
+namespace bt {
+
+/**
+ * @brief Contents of a stolen string: either its heap buffer or an inline copy of a small string.
+ *
+ * Standard-layout and trivially copyable, so it can be returned by value across a C ABI as a
+ * struct with the same members. It does not free the heap buffer on its own; call reset() once,
+ * on exactly one copy, when the contents are no longer needed.
+ *
+ * The size of the inline storage depends on the standard library implementation.
+ */
+template<typename CharT>
+struct steal_result
+{
+	//! Characters which fit in the inline storage, including the null terminator
+	static constexpr std::size_t inline_capacity = detail::small_string_max_size<CharT>() + 1;
+
+	//! Heap buffer allocated by std::allocator<CharT>, or nullptr if the string is stored inline
+	CharT* heap;
+
+	//! Length of the string, not including the null terminator
+	std::size_t size;
+
+	//! Allocated capacity of the heap buffer including the null terminator, or 0 if stored inline
+	std::size_t capacity;
+
+	//! Null-terminated copy of a small string, used when `heap` is nullptr
+	CharT inline_data[inline_capacity];
+
+	//! Null-terminated contents. Points into this object when stored inline.
+	constexpr auto data() noexcept -> CharT* { return heap ? heap : inline_data; }
+	constexpr auto data() const noexcept -> const CharT* { return heap ? heap : inline_data; }
+
+	constexpr auto view() const noexcept -> std::basic_string_view<CharT> { return {data(), size}; }
+
+	constexpr auto is_inline() const noexcept -> bool { return heap == nullptr; }
+
+	//! Deallocates the heap buffer, if any, and leaves the result empty
+	void reset() noexcept
+	{
+		if (heap) {
+			std::allocator<CharT>{}.deallocate(heap, capacity);
+		}
+
+		heap = nullptr;
+		size = 0;
+		capacity = 0;
+		inline_data[0] = CharT();
+	}
+};
+
+/**
+ * @returns string contents, stealing the internal buffer when possible and copying small strings inline
+ *
+ * Never allocates.
+ */
+template<typename CharT>
+BT_STRING_CONSTEXPR23 auto steal_inline(std::basic_string<CharT>&& input) noexcept -> steal_result<CharT>
+{
+	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+	static_assert(std::is_standard_layout_v<steal_result<CharT>> && std::is_trivially_copyable_v<steal_result<CharT>>);
+
+	steal_result<CharT> result{};
+	result.size = input.size();
+
+	if (bt::uses_large_buffer(input)) {
+		result.capacity = input.capacity() + 1;
+		result.heap = detail::try_steal(input);
+		detail::record_steal(detail::StatsKind::string, (result.size + 1) * sizeof(CharT));
+	} else {
+		std::char_traits<CharT>::copy(result.inline_data, input.c_str(), result.size + 1);
+		detail::record_copy(detail::StatsKind::string, (result.size + 1) * sizeof(CharT));
+	}
+
+	return result;
+}
+
+} // namespace bt
+
+#endif // !BT_COPY_BUFFERS
+
+#endif // BUFFER_THIEF_STEAL_RESULT_H
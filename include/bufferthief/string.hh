@@ -14,6 +14,11 @@
 #ifndef BUFFER_THIEF_STRING_H
 #define BUFFER_THIEF_STRING_H
 
+#include "buffer.hh"
+#include "stats.hh"
+#include "steal_policy.hh"
+#include "private/common_string.hh"
+
 #undef BUFFER_THIEF_STRING_IMPLEMENTED
 #if !defined(BT_COPY_BUFFERS)
 #	include "private/string_libc++.hh"
@@ -27,48 +32,140 @@
 namespace bt {
 
 // TODO:
-// - std::pmr::polymorphic_allocator support
 // - ASAN compatibility
 
-template<typename CharT>
-BT_STRING_CONSTEXPR23 auto try_steal(std::basic_string<CharT>& input) noexcept -> std::unique_ptr<CharT[]>
+namespace detail {
+
+//! @returns copy of the string's contents, including the null terminator, allocated by the string's allocator
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR23 auto copy_string(const std::basic_string<CharT, std::char_traits<CharT>, Alloc>& input)
+	-> buffer<CharT, Alloc>
+{
+	const auto size = input.size();
+	Alloc alloc = input.get_allocator();
+	buffer<CharT, Alloc> copy{std::allocator_traits<Alloc>::allocate(alloc, size + 1), 0, size + 1, alloc};
+	std::char_traits<CharT>::copy(copy.data(), input.c_str(), size + 1);
+	copy.commit(size);
+
+	detail::record_copy(StatsKind::string, (size + 1) * sizeof(CharT));
+	return copy;
+}
+
+} // namespace detail
+
+/**
+ * @returns internal buffer of the string, or an empty buffer if the small string optimization is used
+ *
+ * The buffer's capacity() includes the null terminator, and it is deallocated with the string's allocator.
+ */
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR23 auto try_steal(std::basic_string<CharT, std::char_traits<CharT>, Alloc>& input) noexcept
+	-> buffer<CharT, Alloc>
 {
 	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
 
 #if !defined(BT_COPY_BUFFERS)
-	return std::unique_ptr<CharT[]>{detail::try_steal(input)};
-#else
-	return nullptr;
+	const auto size = input.size();
+	const auto capacity = input.capacity() + 1;
+
+	if (CharT* ptr = detail::try_steal(input)) {
+		detail::record_steal(detail::StatsKind::string, (size + 1) * sizeof(CharT));
+		return buffer<CharT, Alloc>{ptr, size, capacity, input.get_allocator()};
+	}
 #endif
+
+	return buffer<CharT, Alloc>{input.get_allocator()};
 }
 
-template<typename CharT>
-BT_STRING_CONSTEXPR23 auto steal(std::basic_string<CharT>&& input) -> std::unique_ptr<CharT[]>
+/**
+ * @returns string contents, stealing the internal buffer when possible and copying it if not
+ *
+ * The buffer's capacity() includes the null terminator, and it is allocated by the string's allocator.
+ */
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR23 auto steal(std::basic_string<CharT, std::char_traits<CharT>, Alloc>&& input)
+	-> buffer<CharT, Alloc>
+{
+	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+
+	if (auto stolen = bt::try_steal(input)) {
+		return stolen;
+	}
+
+	return detail::copy_string(input);
+}
+
+/**
+ * @returns string contents, stealing the internal buffer if `policy` accepts its slack and copying it if not
+ *
+ * `policy` is called with the bytes used and allocated by the buffer, both including the null terminator.
+ * When a large buffer is copied instead, `input` is left empty and its buffer is deallocated before returning.
+ */
+template<typename CharT, typename Alloc, typename Policy, detail::EnableIfStealPolicy<Policy> = 0>
+BT_STRING_CONSTEXPR23 auto steal(std::basic_string<CharT, std::char_traits<CharT>, Alloc>&& input, const Policy& policy)
+	-> buffer<CharT, Alloc>
 {
 	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
 
 #if !defined(BT_COPY_BUFFERS)
-	if (auto buffer = detail::try_steal(input)) {
-		return std::unique_ptr<CharT[]>{buffer};
+	if (detail::uses_large_buffer(input)
+		&& !policy((input.size() + 1) * sizeof(CharT), (input.capacity() + 1) * sizeof(CharT)))
+	{
+		auto copy = detail::copy_string(input);
+		[[maybe_unused]] const auto discarded = std::move(input);
+		return copy;
 	}
-	else
+#else
+	(void)policy;
 #endif
-	{
-		// Copy the buffer
-		CharT* copy = new CharT[input.size() + 1];
-		std::char_traits<CharT>::copy(copy, input.c_str(), input.size());
-		copy[input.size()] = CharT();
 
-		return std::unique_ptr<CharT[]>{copy};
+	return bt::steal(std::move(input));
+}
+
+/**
+ * @brief Creates a string which takes ownership of `input`, copying only if it is small.
+ *
+ * `input` must have room for a null terminator after its contents, as buffers stolen from
+ * strings do. Otherwise, or if it would fit in the small string buffer, it is copied.
+ * The string uses the buffer's allocator.
+ */
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR23 auto adopt(buffer<CharT, Alloc>&& input)
+	-> std::basic_string<CharT, std::char_traits<CharT>, Alloc>
+{
+	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+
+	std::basic_string<CharT, std::char_traits<CharT>, Alloc> output{input.get_allocator()};
+
+#if !defined(BT_COPY_BUFFERS)
+	if (input.spare_capacity() > 0
+		&& input.capacity() - 1 > detail::small_string_max_size<CharT>()
+		&& detail::try_adopt(output, input.data(), input.size(), input.capacity() - 1))
+	{
+		input.release();
+		return output;
 	}
+#endif
+
+	// Copy the buffer
+	output.assign(input.data(), input.size());
+	input.reset();
+
+	return output;
 }
 
 #if !defined(BT_COPY_BUFFERS)
 
-template<typename CharT>
-BT_STRING_CONSTEXPR20 auto uses_large_buffer(const std::basic_string<CharT>& input) noexcept -> bool
+template<typename CharT, typename Alloc>
+BT_STRING_CONSTEXPR20 auto uses_large_buffer(const std::basic_string<CharT, std::char_traits<CharT>, Alloc>& input) noexcept
+	-> bool
 {
 	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
 	return detail::uses_large_buffer(input);
 }
 
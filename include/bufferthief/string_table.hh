@@ -0,0 +1,227 @@
+/*
+ * string_table.hh - Utility for stealing a vector of strings as a C string table
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_STRING_TABLE_H
+#define BUFFER_THIEF_STRING_TABLE_H
+
+#include "string.hh"
+#include "vector.hh"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bt {
+
+template<typename CharT>
+class string_table;
+
+template<typename CharT>
+auto steal_all(std::vector<std::basic_string<CharT>>&& input) -> string_table<CharT>;
+
+/**
+ * @brief Owning table of null-terminated strings, as returned by steal_all().
+ *
+ * Strings which used a large buffer keep that buffer. The rest are packed into a single slab
+ * allocation, which also holds the lengths. The pointer array reuses the vector's buffer.
+ */
+template<typename CharT>
+class string_table
+{
+	using String = std::basic_string<CharT>;
+
+	static_assert(sizeof(String) >= sizeof(CharT*) && alignof(String) >= alignof(CharT*),
+		"The pointer array must fit in the vector's buffer");
+
+public:
+	string_table() noexcept = default;
+
+	string_table(string_table&& other) noexcept
+		: pointers_{std::exchange(other.pointers_, nullptr)}
+		, size_{std::exchange(other.size_, 0)}
+		, pointers_capacity_{std::exchange(other.pointers_capacity_, 0)}
+		, slab_{std::exchange(other.slab_, nullptr)}
+		, slab_size_{std::exchange(other.slab_size_, 0)}
+	{}
+
+	auto operator=(string_table&& other) noexcept -> string_table&
+	{
+		if (this != &other) {
+			reset();
+			pointers_ = std::exchange(other.pointers_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+			pointers_capacity_ = std::exchange(other.pointers_capacity_, 0);
+			slab_ = std::exchange(other.slab_, nullptr);
+			slab_size_ = std::exchange(other.slab_size_, 0);
+		}
+		return *this;
+	}
+
+	string_table(const string_table&) = delete;
+	auto operator=(const string_table&) -> string_table& = delete;
+
+	~string_table()
+	{
+		reset();
+	}
+
+	//! Number of strings
+	auto size() const noexcept -> std::size_t { return size_; }
+
+	auto empty() const noexcept -> bool { return size_ == 0; }
+
+	//! Array of size() null-terminated strings
+	auto data() const noexcept -> CharT* const* { return pointers_; }
+
+	//! Array of size() string lengths, not including the null terminators
+	auto lengths() const noexcept -> const std::size_t* { return slab_; }
+
+	auto operator[](std::size_t index) const noexcept -> std::basic_string_view<CharT>
+	{
+		return {pointers_[index], slab_[index]};
+	}
+
+	//! Deallocates every string and the table itself
+	void reset() noexcept
+	{
+		for (std::size_t i = 0; i < size_; ++i) {
+			if (const auto capacity = capacities()[i]; capacity != 0) {
+				std::allocator<CharT>{}.deallocate(pointers_[i], capacity);
+			}
+		}
+
+		if (slab_) {
+			std::allocator<std::size_t>{}.deallocate(slab_, slab_size_);
+		}
+
+		if (pointers_) {
+			// The pointer array lives in storage allocated for strings
+			std::allocator<String>{}.deallocate(reinterpret_cast<String*>(pointers_), pointers_capacity_);
+		}
+
+		pointers_ = nullptr;
+		size_ = 0;
+		pointers_capacity_ = 0;
+		slab_ = nullptr;
+		slab_size_ = 0;
+	}
+
+private:
+	friend auto steal_all<CharT>(std::vector<String>&& input) -> string_table;
+
+	//! Allocated capacity of each string including the null terminator, or 0 if it was packed into the slab
+	auto capacities() const noexcept -> std::size_t* { return slab_ + size_; }
+
+	CharT** pointers_ = nullptr;
+	std::size_t size_ = 0;
+	std::size_t pointers_capacity_ = 0; //!< in strings
+
+	//! Lengths, then capacities, then the packed strings
+	std::size_t* slab_ = nullptr;
+	std::size_t slab_size_ = 0;
+};
+
+/**
+ * @returns table of the vector's strings, stealing every buffer it can
+ *
+ * Strings which use a large buffer are stolen, while the rest are packed into one allocation,
+ * so the table makes at most one allocation regardless of the number of strings.
+ * The vector is left empty with no buffer. If an exception is thrown, the vector is unchanged.
+ */
+template<typename CharT>
+auto steal_all(std::vector<std::basic_string<CharT>>&& input) -> string_table<CharT>
+{
+	static_assert(detail::SupportedChar<CharT>::value, "Unsupported character type");
+
+	using String = std::basic_string<CharT>;
+
+	string_table<CharT> table;
+	const auto size = input.size();
+
+	// Measure the strings which must be copied
+	std::size_t packed_size = 0;
+	for (const auto& str : input) {
+#if !defined(BT_COPY_BUFFERS)
+		if (detail::uses_large_buffer(str)) { continue; }
+#endif
+		packed_size += str.size() + 1;
+	}
+
+	const auto packed_words = (packed_size * sizeof(CharT) + sizeof(std::size_t) - 1) / sizeof(std::size_t);
+	if (const auto slab_size = 2 * size + packed_words; slab_size > 0) {
+		table.slab_ = std::allocator<std::size_t>{}.allocate(slab_size);
+		table.slab_size_ = slab_size;
+	}
+
+#if !defined(BT_COPY_BUFFERS)
+	auto outer = bt::steal(std::move(input));
+	table.pointers_capacity_ = outer.capacity();
+	String* strings = outer.release();
+	auto* storage = reinterpret_cast<unsigned char*>(strings);
+#else
+	String* strings = input.data();
+	unsigned char* storage = nullptr;
+	if (size > 0) {
+		storage = reinterpret_cast<unsigned char*>(std::allocator<String>{}.allocate(size));
+		table.pointers_capacity_ = size;
+	}
+#endif
+
+	table.pointers_ = reinterpret_cast<CharT**>(storage);
+	table.size_ = size;
+
+	std::size_t* lengths = table.slab_;
+	std::size_t* capacities = table.capacities();
+	auto* packed = reinterpret_cast<CharT*>(table.slab_ + 2 * size);
+
+	for (std::size_t i = 0; i < size; ++i) {
+		String& str = strings[i];
+		CharT* ptr = nullptr;
+
+		lengths[i] = str.size();
+		capacities[i] = 0;
+
+#if !defined(BT_COPY_BUFFERS)
+		if (detail::uses_large_buffer(str)) {
+			capacities[i] = str.capacity() + 1;
+			ptr = detail::try_steal(str);
+		} else
+#endif
+		{
+			ptr = packed;
+			std::char_traits<CharT>::copy(ptr, str.c_str(), str.size() + 1);
+			packed += str.size() + 1;
+		}
+
+#if !defined(BT_COPY_BUFFERS)
+		// Now a small string, so nothing is deallocated
+		str.~String();
+#endif
+
+		// Strings are larger than pointers, so this only overwrites strings which were already destroyed
+		::new (static_cast<void*>(storage + i * sizeof(CharT*))) CharT*(ptr);
+	}
+
+#if defined(BT_COPY_BUFFERS)
+	std::vector<String>{}.swap(input);
+#endif
+
+	return table;
+}
+
+} // namespace bt
+
+#endif // BUFFER_THIEF_STRING_TABLE_H
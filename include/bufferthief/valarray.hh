@@ -0,0 +1,68 @@
+/*
+ * valarray.hh - Utility for stealing the internal buffer of std::valarray
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_VALARRAY_H
+#define BUFFER_THIEF_VALARRAY_H
+
+#include "buffer.hh"
+#include "private/common_valarray.hh"
+
+#undef BUFFER_THIEF_VALARRAY_IMPLEMENTED
+#if !defined(BT_COPY_BUFFERS)
+#	include "private/valarray_libc++.hh"
+#	include "private/valarray_libstdc++.hh"
+#	if !defined(BUFFER_THIEF_VALARRAY_IMPLEMENTED)
+#		error "No supported C++ Standard Library implementation detected"
+#	endif
+#endif
+
+namespace bt {
+
+#if defined(BT_COPY_BUFFERS)
+#define BT_NOEXCEPT
+#else
+#define BT_NOEXCEPT noexcept
+#endif
+
+/**
+ * @returns internal buffer of the valarray, or an empty buffer if it has none
+ *
+ * A valarray has no spare capacity, so the buffer's capacity is its size.
+ * The valarray is left empty.
+ */
+template<typename T>
+auto steal(std::valarray<T>&& input) BT_NOEXCEPT -> buffer<T>
+{
+	const auto size = input.size();
+	if (size == 0) { return buffer<T>{}; }
+
+#if !defined(BT_COPY_BUFFERS)
+	return buffer<T>{detail::steal(input), size, size};
+#else
+	std::allocator<T> alloc;
+	buffer<T> copy{alloc.allocate(size), 0, size};
+	std::uninitialized_copy(std::begin(input), std::end(input), copy.data());
+	copy.commit(size);
+
+	input = std::valarray<T>{};
+	return copy;
+#endif
+}
+
+#undef BT_NOEXCEPT
+
+} // namespace bt
+
+#undef BUFFER_THIEF_VALARRAY_IMPLEMENTED
+
+#endif // BUFFER_THIEF_VALARRAY_H
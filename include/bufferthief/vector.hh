@@ -14,9 +14,14 @@
 #ifndef BUFFER_THIEF_VECTOR_H
 #define BUFFER_THIEF_VECTOR_H
 
+#include "buffer.hh"
+#include "stats.hh"
+#include "steal_policy.hh"
+#include "private/common_vector.hh"
+
 #undef BUFFER_THIEF_VECTOR_IMPLEMENTED
 #if !defined(BT_COPY_BUFFERS)
-//#	include "private/vector_libc++.hh"
+#	include "private/vector_libc++.hh"
 #	include "private/vector_libstdc++.hh"
 //#	include "private/vector_msvc_stl.hh"
 #	if !defined(BUFFER_THIEF_VECTOR_IMPLEMENTED)
@@ -27,7 +32,6 @@
 namespace bt {
 
 // TODO:
-// - std::pmr::polymorphic_allocator support
 // - ASAN compatibility
 
 #if defined(BT_COPY_BUFFERS)
@@ -36,21 +40,106 @@ namespace bt {
 #define BT_NOEXCEPT noexcept
 #endif
 
-template<typename T>
-BT_VECTOR_CONSTEXPR23 auto steal(std::vector<T>&& input) BT_NOEXCEPT -> std::unique_ptr<T[]>
+/**
+ * @returns internal buffer of the vector, or an empty buffer if it has none
+ *
+ * The buffer is deallocated with the vector's allocator.
+ */
+template<typename T, typename Alloc>
+BT_VECTOR_CONSTEXPR23 auto steal(std::vector<T, Alloc>&& input) BT_NOEXCEPT -> buffer<T, Alloc>
 {
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+	static_assert(!std::is_same_v<T, bool>, "use bt::steal_bits for std::vector<bool>");
+
 #if !defined(BT_COPY_BUFFERS)
-	return std::unique_ptr<T[]>{detail::steal(input)};
+	const auto size = input.size();
+	const auto capacity = input.capacity();
+
+	if (capacity > 0) {
+		detail::record_steal(detail::StatsKind::vector, size * sizeof(T));
+	}
+
+	return buffer<T, Alloc>{detail::steal(input), size, capacity, input.get_allocator()};
 #else
-	if (input.empty()) { return nullptr; }
-	
-	T* copy = std::allocator<T>{}.allocate(input.size());
-	std::uninitialized_copy(input.begin(), input.end(), copy);
+	if (input.empty()) { return buffer<T, Alloc>{input.get_allocator()}; }
 
-	return std::unique_ptr<T[]>{copy};
+	const auto size = input.size();
+	Alloc alloc = input.get_allocator();
+	buffer<T, Alloc> copy{std::allocator_traits<Alloc>::allocate(alloc, size), 0, size, alloc};
+	std::uninitialized_copy(input.begin(), input.end(), copy.data());
+	copy.commit(size);
+
+	detail::record_copy(detail::StatsKind::vector, size * sizeof(T));
+	return copy;
 #endif
 }
 
+/**
+ * @returns internal buffer of the vector if `policy` accepts its slack, or a tight copy if not
+ *
+ * `policy` is called with the bytes used and allocated by the buffer. When the buffer is
+ * copied instead, elements are moved if that cannot throw and copied otherwise, and `input`
+ * is left empty with its buffer deallocated before returning.
+ */
+template<typename T, typename Alloc, typename Policy, detail::EnableIfStealPolicy<Policy> = 0>
+BT_VECTOR_CONSTEXPR23 auto steal(std::vector<T, Alloc>&& input, const Policy& policy) -> buffer<T, Alloc>
+{
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+	static_assert(!std::is_same_v<T, bool>, "use bt::steal_bits for std::vector<bool>");
+
+#if !defined(BT_COPY_BUFFERS)
+	const auto size = input.size();
+	if (policy(size * sizeof(T), input.capacity() * sizeof(T))) {
+		return bt::steal(std::move(input));
+	}
+
+	Alloc alloc = input.get_allocator();
+	buffer<T, Alloc> copy{alloc};
+	if (size > 0) {
+		copy = buffer<T, Alloc>{std::allocator_traits<Alloc>::allocate(alloc, size), 0, size, alloc};
+		if constexpr (std::is_nothrow_move_constructible_v<T>) {
+			std::uninitialized_move(input.begin(), input.end(), copy.data());
+		} else {
+			std::uninitialized_copy(input.begin(), input.end(), copy.data());
+		}
+		copy.commit(size);
+	}
+
+	detail::record_copy(detail::StatsKind::vector, size * sizeof(T));
+	[[maybe_unused]] const auto discarded = std::move(input);
+	return copy;
+#else
+	(void)policy;
+	return bt::steal(std::move(input));
+#endif
+}
+
+/**
+ * @brief Creates a vector which takes ownership of `input`.
+ * The vector uses the buffer's allocator.
+ */
+template<typename T, typename Alloc>
+BT_VECTOR_CONSTEXPR23 auto adopt_vector(buffer<T, Alloc>&& input) BT_NOEXCEPT -> std::vector<T, Alloc>
+{
+	static_assert(detail::SupportedAllocator<Alloc>::value, "Unsupported allocator type");
+	static_assert(!std::is_same_v<T, bool>, "std::vector<bool> is packed and cannot adopt a buffer of bools");
+
+	std::vector<T, Alloc> output{input.get_allocator()};
+	if (!input) { return output; }
+
+#if !defined(BT_COPY_BUFFERS)
+	const auto size = input.size();
+	const auto capacity = input.capacity();
+
+	detail::adopt(output, input.release(), size, capacity);
+#else
+	output.assign(std::make_move_iterator(input.begin()), std::make_move_iterator(input.end()));
+	input.reset();
+#endif
+
+	return output;
+}
+
 #undef BT_NOEXCEPT
 
 } // namespace bt
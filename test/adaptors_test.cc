@@ -0,0 +1,105 @@
+/*
+ * adaptors_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/adaptors.hh>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stack>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for stealing from container adaptors
+class AdaptorsTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(AdaptorsTest, PriorityQueue)
+{
+	auto q1 = std::priority_queue<int>{};
+	for (int i : {5, 1, 9, 3, 7}) { q1.push(i); }
+	const int* top = &q1.top();
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(q1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	EXPECT_TRUE(q1.empty());
+	ASSERT_EQ(b1.size(), 5);
+	EXPECT_EQ(b1.data(), top);
+	EXPECT_TRUE(std::is_heap(b1.begin(), b1.end()));
+	EXPECT_EQ(b1[0], 9);
+
+	std::sort_heap(b1.begin(), b1.end());
+	EXPECT_EQ(std::vector<int>(b1.begin(), b1.end()), (std::vector<int>{1, 3, 5, 7, 9}));
+}
+
+TEST_F(AdaptorsTest, MinHeap)
+{
+	auto q1 = std::priority_queue<int, std::vector<int>, std::greater<int>>{};
+	for (int i : {5, 1, 9}) { q1.push(i); }
+
+	auto b1 = bt::steal(std::move(q1));
+	EXPECT_TRUE(std::is_heap(b1.begin(), b1.end(), std::greater<int>{}));
+	EXPECT_EQ(b1[0], 1);
+}
+
+TEST_F(AdaptorsTest, StackOverVector)
+{
+	auto s1 = std::stack<int, std::vector<int>>{};
+	s1.push(1);
+	s1.push(2);
+	s1.push(3);
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(s1));
+	ALLOC_EXPECT_EQ(0);
+
+	EXPECT_TRUE(s1.empty());
+	ASSERT_EQ(b1.size(), 3);
+	EXPECT_EQ(b1[2], 3); // top
+}
+
+TEST_F(AdaptorsTest, Deques)
+{
+	auto s1 = std::stack<int>{};
+	s1.push(1);
+	s1.push(2);
+	auto l1 = bt::steal_segments(std::move(s1));
+	EXPECT_TRUE(s1.empty());
+	ASSERT_EQ(l1.size(), 1);
+	EXPECT_EQ(l1[0].data[1], 2); // top
+
+	auto q1 = std::queue<int>{};
+	q1.push(1);
+	q1.push(2);
+	q1.push(3);
+	q1.pop();
+	auto l2 = bt::steal_segments(std::move(q1));
+	EXPECT_TRUE(q1.empty());
+	ASSERT_EQ(l2.total_size(), 2);
+	EXPECT_EQ(l2[0].data[0], 2); // front
+}
@@ -0,0 +1,189 @@
+/*
+ * allocation_counter.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+//! Trivial, so it is usable before and after any other thread_local object
+struct Counts
+{
+	bool active;
+	std::size_t allocations;
+	std::size_t deallocations;
+	std::size_t bytes;
+};
+
+thread_local Counts counts_{};
+
+void countAllocation(std::size_t n) noexcept
+{
+	if (counts_.active) {
+		++counts_.allocations;
+		counts_.bytes += n;
+	}
+}
+
+void countDeallocation(void* p) noexcept
+{
+	if (p && counts_.active) {
+		++counts_.deallocations;
+	}
+}
+
+/*
+ * Each block is preceded by the size it was requested with, so sized deletes can be checked.
+ * Replacing operator delete hides size mismatches from AddressSanitizer, so they are caught here.
+ */
+constexpr std::size_t header_size = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void checkSize(void* p, std::size_t n) noexcept
+{
+	const auto allocated = static_cast<std::size_t*>(p)[-1];
+	if (n != allocated) {
+		std::fprintf(stderr, "operator delete: size %zu does not match allocated size %zu\n", n, allocated);
+		std::abort();
+	}
+}
+
+auto allocate(std::size_t n) noexcept -> void*
+{
+	auto* base = static_cast<std::byte*>(std::malloc(header_size + n));
+	if (!base) { return nullptr; }
+
+	void* p = base + header_size;
+	static_cast<std::size_t*>(p)[-1] = n;
+
+	countAllocation(n);
+	return p;
+}
+
+void deallocate(void* p) noexcept
+{
+	if (!p) { return; }
+	countDeallocation(p);
+	std::free(static_cast<std::byte*>(p) - header_size);
+}
+
+void deallocate(void* p, std::size_t n) noexcept
+{
+	if (p) { checkSize(p, n); }
+	deallocate(p);
+}
+
+/*
+ * Over-aligned blocks are allocated with malloc, with the original pointer and the size stored
+ * just before the aligned address. This avoids aligned_alloc, which MSVC lacks.
+ */
+auto allocateAligned(std::size_t n, std::align_val_t al) noexcept -> void*
+{
+	const auto alignment = static_cast<std::size_t>(al);
+	void* base = std::malloc(n + alignment + 2 * sizeof(void*));
+	if (!base) { return nullptr; }
+
+	const auto address = reinterpret_cast<std::uintptr_t>(base) + 2 * sizeof(void*);
+	auto* p = reinterpret_cast<void*>((address + alignment - 1) & ~(alignment - 1));
+	static_cast<std::size_t*>(p)[-1] = n;
+	static_cast<void**>(p)[-2] = base;
+
+	countAllocation(n);
+	return p;
+}
+
+void deallocateAligned(void* p) noexcept
+{
+	if (!p) { return; }
+	countDeallocation(p);
+	std::free(static_cast<void**>(p)[-2]);
+}
+
+void deallocateAligned(void* p, std::size_t n) noexcept
+{
+	if (p) { checkSize(p, n); }
+	deallocateAligned(p);
+}
+
+} // namespace
+
+AllocationCounter::AllocationCounter() noexcept
+{
+	counts_ = Counts{true, 0, 0, 0};
+}
+
+AllocationCounter::~AllocationCounter()
+{
+	counts_.active = false;
+}
+
+auto AllocationCounter::allocations() const noexcept -> std::size_t { return counts_.allocations; }
+auto AllocationCounter::deallocations() const noexcept -> std::size_t { return counts_.deallocations; }
+auto AllocationCounter::bytesAllocated() const noexcept -> std::size_t { return counts_.bytes; }
+
+void AllocationCounter::reset() noexcept
+{
+	counts_.allocations = 0;
+	counts_.deallocations = 0;
+	counts_.bytes = 0;
+}
+
+///////////////////////////////////////////////////
+
+void* operator new(std::size_t n) noexcept(false)
+{
+	if (void* p = allocate(n)) { return p; }
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t n) noexcept(false)
+{
+	if (void* p = allocate(n)) { return p; }
+	throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return allocate(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return allocate(n); }
+
+void* operator new(std::size_t n, std::align_val_t al) noexcept(false)
+{
+	if (void* p = allocateAligned(n, al)) { return p; }
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t n, std::align_val_t al) noexcept(false)
+{
+	if (void* p = allocateAligned(n, al)) { return p; }
+	throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept { return allocateAligned(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al, const std::nothrow_t&) noexcept { return allocateAligned(n, al); }
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t n) noexcept { deallocate(p, n); }
+void operator delete[](void* p, std::size_t n) noexcept { deallocate(p, n); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { deallocateAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { deallocateAligned(p); }
+void operator delete(void* p, std::size_t n, std::align_val_t) noexcept { deallocateAligned(p, n); }
+void operator delete[](void* p, std::size_t n, std::align_val_t) noexcept { deallocateAligned(p, n); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(p); }
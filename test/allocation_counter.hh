@@ -0,0 +1,68 @@
+/*
+ * allocation_counter.hh - Counts global operator new/delete calls made by the current thread
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BUFFER_THIEF_TEST_ALLOCATION_COUNTER_H
+#define BUFFER_THIEF_TEST_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+/**
+ * Whether allocation counts are exact on this platform.
+ * MSVC STL's Debug configuration allocates for iterator debugging.
+ */
+#if defined(_MSC_VER) && defined(_DEBUG)
+#	define TEST_ALLOCATIONS 0
+#else
+#	define TEST_ALLOCATIONS 1
+#endif
+
+/**
+ * @brief Counts allocations made by the calling thread while it is alive.
+ *
+ * allocation_counter.cc replaces every form of the global operator new and delete, so
+ * it must be compiled into the test executable. Allocations made by other threads, or
+ * by this thread while no counter is alive, are not counted. A sized delete whose size
+ * differs from the allocated size aborts the test executable on any thread.
+ */
+class AllocationCounter
+{
+public:
+	AllocationCounter() noexcept;
+	~AllocationCounter();
+
+	AllocationCounter(const AllocationCounter&) = delete;
+	auto operator=(const AllocationCounter&) -> AllocationCounter& = delete;
+
+	auto allocations() const noexcept -> std::size_t;
+	auto deallocations() const noexcept -> std::size_t;
+
+	//! Total bytes requested by counted allocations
+	auto bytesAllocated() const noexcept -> std::size_t;
+
+	//! Sets the counts to zero
+	void reset() noexcept;
+};
+
+#if TEST_ALLOCATIONS == 1
+#	define ALLOC_EXPECT_EQ(x) EXPECT_EQ(counter_.allocations(), (x))
+#	define DEALLOC_EXPECT_EQ(x) EXPECT_EQ(counter_.deallocations(), (x))
+#	define BYTES_EXPECT_EQ(x) EXPECT_EQ(counter_.bytesAllocated(), (x))
+#	define BYTES_EXPECT_GE(x) EXPECT_GE(counter_.bytesAllocated(), (x))
+#else
+#	define ALLOC_EXPECT_EQ(x)
+#	define DEALLOC_EXPECT_EQ(x)
+#	define BYTES_EXPECT_EQ(x)
+#	define BYTES_EXPECT_GE(x)
+#endif
+
+#endif // BUFFER_THIEF_TEST_ALLOCATION_COUNTER_H
@@ -0,0 +1,159 @@
+/*
+ * arrow_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/arrow.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for Arrow exports
+class ArrowTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(ArrowTest, Int64)
+{
+	auto v1 = std::vector<std::int64_t>{1, 2, 3, 4, 5};
+	const auto* data = v1.data();
+
+	ArrowArray array;
+	ArrowSchema schema;
+
+	counter_.reset();
+	bt::to_arrow(std::move(v1), &array, &schema);
+	ALLOC_EXPECT_EQ(1); // private data only
+	EXPECT_EQ(v1.data(), nullptr);
+
+	EXPECT_STREQ(schema.format, "l");
+	EXPECT_STREQ(schema.name, "");
+	EXPECT_EQ(schema.n_children, 0);
+	ASSERT_NE(schema.release, nullptr);
+
+	EXPECT_EQ(array.length, 5);
+	EXPECT_EQ(array.null_count, 0);
+	EXPECT_EQ(array.offset, 0);
+	EXPECT_EQ(array.n_buffers, 2);
+	EXPECT_EQ(array.n_children, 0);
+	EXPECT_EQ(array.buffers[0], nullptr);
+	EXPECT_EQ(array.buffers[1], data);
+	ASSERT_NE(array.release, nullptr);
+
+	const auto* values = static_cast<const std::int64_t*>(array.buffers[1]);
+	EXPECT_EQ(values[0], 1);
+	EXPECT_EQ(values[4], 5);
+
+	array.release(&array);
+	schema.release(&schema);
+	EXPECT_EQ(array.release, nullptr);
+	EXPECT_EQ(schema.release, nullptr);
+	DEALLOC_EXPECT_EQ(2);
+}
+
+TEST_F(ArrowTest, Double)
+{
+	auto v1 = std::vector<double>{0.5, 1.5};
+
+	ArrowArray array;
+	ArrowSchema schema;
+	bt::to_arrow(std::move(v1), &array, &schema);
+
+	EXPECT_STREQ(schema.format, "g");
+	EXPECT_EQ(array.length, 2);
+	EXPECT_EQ(static_cast<const double*>(array.buffers[1])[1], 1.5);
+
+	array.release(&array);
+	schema.release(&schema);
+}
+
+TEST_F(ArrowTest, EmptyVector)
+{
+	auto v1 = std::vector<std::uint8_t>{};
+
+	ArrowArray array;
+	ArrowSchema schema;
+	bt::to_arrow(std::move(v1), &array, &schema);
+
+	EXPECT_STREQ(schema.format, "C");
+	EXPECT_EQ(array.length, 0);
+
+	array.release(&array);
+	schema.release(&schema);
+}
+
+TEST_F(ArrowTest, Strings)
+{
+	const auto large = std::string(100, 'x');
+	auto v1 = std::vector<std::string>{"abc", "", large, "de"};
+	const void* outer = v1.data();
+
+	ArrowArray array;
+	ArrowSchema schema;
+
+	counter_.reset();
+	bt::to_arrow(std::move(v1), &array, &schema);
+	ALLOC_EXPECT_EQ(2); // private data and the data buffer
+	DEALLOC_EXPECT_EQ(1); // the large string
+	EXPECT_EQ(v1.data(), nullptr);
+
+	EXPECT_STREQ(schema.format, "u");
+	EXPECT_EQ(array.length, 4);
+	EXPECT_EQ(array.n_buffers, 3);
+	EXPECT_EQ(array.buffers[0], nullptr);
+	EXPECT_EQ(array.buffers[1], outer); // reuses the vector's buffer
+
+	const auto* offsets = static_cast<const std::int32_t*>(array.buffers[1]);
+	EXPECT_EQ(offsets[0], 0);
+	EXPECT_EQ(offsets[1], 3);
+	EXPECT_EQ(offsets[2], 3);
+	EXPECT_EQ(offsets[3], 103);
+	EXPECT_EQ(offsets[4], 105);
+
+	const auto* chars = static_cast<const char*>(array.buffers[2]);
+	EXPECT_EQ(std::string_view(chars, 3), "abc");
+	EXPECT_EQ(std::string_view(chars + 3, 100), large);
+	EXPECT_EQ(std::string_view(chars + 103, 2), "de");
+
+	array.release(&array);
+	schema.release(&schema);
+	DEALLOC_EXPECT_EQ(4);
+}
+
+TEST_F(ArrowTest, EmptyStrings)
+{
+	auto v1 = std::vector<std::string>{};
+
+	ArrowArray array;
+	ArrowSchema schema;
+	bt::to_arrow(std::move(v1), &array, &schema);
+
+	EXPECT_STREQ(schema.format, "u");
+	EXPECT_EQ(array.length, 0);
+	EXPECT_EQ(static_cast<const std::int32_t*>(array.buffers[1])[0], 0);
+
+	array.release(&array);
+	schema.release(&schema);
+}
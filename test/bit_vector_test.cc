@@ -0,0 +1,96 @@
+/*
+ * bit_vector_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/bit_vector.hh>
+#include <bufferthief/malloc_allocator.hh>
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for stealing the words of std::vector<bool>
+class BitVectorTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(BitVectorTest, Bits)
+{
+	auto v1 = std::vector<bool>(1000);
+	for (std::size_t i = 0; i < v1.size(); i += 3) { v1[i] = true; }
+	const auto expected = v1;
+
+	counter_.reset();
+	auto b1 = bt::steal_bits(std::move(v1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	EXPECT_TRUE(v1.empty());
+	EXPECT_EQ(v1.capacity(), 0);
+	EXPECT_EQ(b1.size(), 1000);
+	EXPECT_EQ(b1.words.size(), (1000 + b1.bits_per_word - 1) / b1.bits_per_word);
+	EXPECT_GE(b1.words.capacity(), b1.words.size());
+
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		ASSERT_EQ(b1.test(i), expected[i]) << "bit " << i;
+	}
+
+	// Least significant bit first
+	EXPECT_EQ(b1.words[0] & 0xF, 0b1001u);
+
+	// The vector is still usable
+	v1.push_back(true);
+	EXPECT_EQ(v1.size(), 1);
+
+	b1.words.reset();
+	DEALLOC_EXPECT_EQ(1);
+}
+
+TEST_F(BitVectorTest, Empty)
+{
+	auto v1 = std::vector<bool>{};
+	auto b1 = bt::steal_bits(std::move(v1));
+	EXPECT_TRUE(b1.empty());
+	EXPECT_EQ(b1.words, nullptr);
+
+	// Cleared, but still holding words
+	auto v2 = std::vector<bool>(100, true);
+	v2.clear();
+	auto b2 = bt::steal_bits(std::move(v2));
+	EXPECT_TRUE(b2.empty());
+	EXPECT_EQ(b2.words.size(), 0);
+	EXPECT_EQ(v2.capacity(), 0);
+}
+
+TEST_F(BitVectorTest, CustomAllocator)
+{
+	auto v1 = bt::vector<bool>(70, true);
+
+	counter_.reset();
+	auto b1 = bt::steal_bits(std::move(v1));
+	EXPECT_EQ(b1.size(), 70);
+	EXPECT_TRUE(b1.test(69));
+	b1.words.reset();
+
+	// Deallocated with std::free
+	DEALLOC_EXPECT_EQ(0);
+}
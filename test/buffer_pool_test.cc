@@ -0,0 +1,166 @@
+/*
+ * buffer_pool_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/buffer_pool.hh>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for the buffer pool
+class BufferPoolTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		bt::buffer_pool::instance().trim();
+		counter_.reset();
+	}
+
+	void TearDown() override
+	{
+		bt::buffer_pool::instance().trim();
+	}
+
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(BufferPoolTest, StringRoundTrip)
+{
+	auto& pool = bt::buffer_pool::instance();
+
+	auto s1 = pool.make_string<char>(100);
+	EXPECT_TRUE(s1.empty());
+	EXPECT_GE(s1.capacity(), 100);
+	s1.assign(100, 'a');
+
+	auto b1 = bt::steal(std::move(s1));
+	const char* data = b1.get();
+	pool.recycle(std::move(b1));
+	EXPECT_EQ(b1, nullptr);
+
+	// The recycled buffer seeds the next string of a similar size
+	counter_.reset();
+	auto s2 = pool.make_string<char>(90);
+	ALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(s2.data(), data);
+	EXPECT_TRUE(s2.empty());
+	EXPECT_GE(s2.capacity(), 90);
+
+	s2.assign(90, 'b');
+	EXPECT_EQ(s2, std::string(90, 'b'));
+}
+
+TEST_F(BufferPoolTest, SmallString)
+{
+	auto& pool = bt::buffer_pool::instance();
+
+	counter_.reset();
+	auto s1 = pool.make_string<char>(bt::small_string_max_size<char>());
+	EXPECT_FALSE(bt::uses_large_buffer(s1));
+	ALLOC_EXPECT_EQ(0);
+}
+
+TEST_F(BufferPoolTest, VectorRoundTrip)
+{
+	auto& pool = bt::buffer_pool::instance();
+
+	auto v1 = pool.make_vector<float>(1000);
+	EXPECT_TRUE(v1.empty());
+	EXPECT_GE(v1.capacity(), 1000);
+	v1.resize(1000, 1.f);
+
+	auto b1 = bt::steal(std::move(v1));
+	const float* data = b1.get();
+	pool.recycle(std::move(b1));
+
+	counter_.reset();
+	auto v2 = pool.make_vector<float>(1000);
+	ALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(v2.data(), data);
+}
+
+TEST_F(BufferPoolTest, CrossType)
+{
+	auto& pool = bt::buffer_pool::instance();
+
+	auto v1 = pool.make_vector<std::uint32_t>(64);
+	const void* data = v1.data();
+	pool.recycle(bt::steal(std::move(v1)));
+
+	// Storage is shared between element types of compatible sizes
+	auto s1 = pool.make_string<char16_t>(100);
+	EXPECT_EQ(static_cast<const void*>(s1.data()), data);
+	s1.assign(100, u'x');
+	EXPECT_EQ(s1, std::u16string(100, u'x'));
+}
+
+TEST_F(BufferPoolTest, NonTrivial)
+{
+	auto& pool = bt::buffer_pool::instance();
+
+	auto v1 = pool.make_vector<std::string>(8);
+	v1.emplace_back(100, 'a');
+	v1.emplace_back(100, 'b');
+
+	// The elements are destroyed when recycled (checked with sanitizers)
+	pool.recycle(bt::steal(std::move(v1)));
+}
+
+TEST_F(BufferPoolTest, NonPowerOfTwoElement)
+{
+	struct Element { char data[24]; };
+	auto& pool = bt::buffer_pool::instance();
+
+	{
+		auto v1 = pool.make_vector<Element>(3);
+		EXPECT_GE(v1.capacity(), 3);
+		ALLOC_EXPECT_EQ(1);
+		BYTES_EXPECT_EQ(v1.capacity() * sizeof(Element));
+	}
+
+	// Freed with the same size it was allocated with (checked with sanitizers)
+	DEALLOC_EXPECT_EQ(1);
+}
+
+TEST_F(BufferPoolTest, SharedOverflow)
+{
+	auto& pool = bt::buffer_pool::instance();
+
+	std::vector<const char*> recycled;
+	std::thread producer{[&] {
+		for (std::size_t i = 0; i < bt::buffer_pool::thread_cache_size + 1; ++i) {
+			auto b = bt::steal(std::string(200, 'a'));
+			recycled.push_back(b.get());
+			pool.recycle(std::move(b));
+		}
+		// The rest of this thread's cache is flushed to the shared list when the thread exits
+	}};
+	producer.join();
+
+	// Another thread is seeded from the shared overflow list
+	auto s1 = pool.make_string<char>(200);
+	EXPECT_NE(std::find(recycled.begin(), recycled.end(), s1.data()), recycled.end());
+}
@@ -0,0 +1,129 @@
+/*
+ * buffer_queue_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <bufferthief/buffer_queue.hh>
+#include <bufferthief/string.hh>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+namespace {
+
+auto view(const bt::buffer<char>& b) -> std::string_view
+{
+	return {b.get(), b.size()};
+}
+
+} // namespace
+
+TEST(BufferQueueTest, PushPop)
+{
+	bt::buffer_queue<char> queue{3};
+	EXPECT_EQ(queue.capacity(), 4);
+
+	auto s1 = std::string(100, 'a');
+	const char* data = s1.data();
+	EXPECT_TRUE(queue.try_push(bt::steal(std::move(s1))));
+	EXPECT_TRUE(queue.try_push(bt::steal(std::string("b"))));
+
+	bt::buffer<char> b1;
+	ASSERT_TRUE(queue.try_pop(b1));
+	EXPECT_EQ(b1.get(), data);
+	EXPECT_EQ(view(b1), std::string(100, 'a'));
+
+	ASSERT_TRUE(queue.try_pop(b1));
+	EXPECT_EQ(view(b1), "b");
+
+	EXPECT_FALSE(queue.try_pop(b1));
+	EXPECT_EQ(view(b1), "b");
+}
+
+TEST(BufferQueueTest, Full)
+{
+	bt::buffer_queue<char> queue{2};
+	EXPECT_TRUE(queue.try_push(bt::steal(std::string("a"))));
+	EXPECT_TRUE(queue.try_push(bt::steal(std::string("b"))));
+
+	// The rejected buffer stays with the caller
+	auto b1 = bt::steal(std::string("c"));
+	EXPECT_FALSE(queue.try_push(std::move(b1)));
+	EXPECT_EQ(view(b1), "c");
+
+	bt::buffer<char> b2;
+	ASSERT_TRUE(queue.try_pop(b2));
+	EXPECT_TRUE(queue.try_push(std::move(b1)));
+
+	// Leftover buffers are destroyed with the queue
+}
+
+TEST(BufferQueueTest, PopBatch)
+{
+	bt::buffer_queue<char, std::allocator<char>, true> queue{8};
+	for (char c = 'a'; c < 'f'; ++c) {
+		EXPECT_TRUE(queue.try_push(bt::steal(std::string(1, c))));
+	}
+
+	bt::buffer<char> output[4];
+	EXPECT_EQ(queue.try_pop(output, 4), 4);
+	EXPECT_EQ(view(output[0]), "a");
+	EXPECT_EQ(view(output[3]), "d");
+
+	EXPECT_EQ(queue.try_pop(output, 4), 1);
+	EXPECT_EQ(view(output[0]), "e");
+	EXPECT_EQ(queue.try_pop(output, 4), 0);
+}
+
+TEST(BufferQueueTest, MultipleProducers)
+{
+	constexpr std::size_t producers = 4;
+	constexpr std::size_t per_producer = 10000;
+
+	bt::buffer_queue<char> queue{64};
+
+	std::vector<std::thread> threads;
+	for (std::size_t p = 0; p < producers; ++p) {
+		threads.emplace_back([&queue, p] {
+			for (std::size_t i = 0; i < per_producer; ++i) {
+				auto item = bt::steal(std::to_string(p) + ":" + std::to_string(i) + std::string(20, 'x'));
+				while (!queue.try_push(std::move(item))) { std::this_thread::yield(); }
+			}
+		});
+	}
+
+	// Each producer's buffers arrive in order
+	std::vector<std::size_t> next(producers, 0);
+	bt::buffer<char> output[16];
+	for (std::size_t received = 0; received < producers * per_producer;) {
+		const auto count = queue.try_pop(output, 16);
+		for (std::size_t i = 0; i < count; ++i) {
+			const auto text = view(output[i]);
+			const auto p = static_cast<std::size_t>(text[0] - '0');
+			ASSERT_LT(p, producers);
+			ASSERT_EQ(text.substr(2, text.find('x') - 2), std::to_string(next[p]));
+			++next[p];
+		}
+		received += count;
+		if (count == 0) { std::this_thread::yield(); }
+	}
+
+	for (auto& thread : threads) { thread.join(); }
+}
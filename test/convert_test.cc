@@ -0,0 +1,145 @@
+/*
+ * convert_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/convert.hh>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for conversions between strings and vectors
+class ConvertTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		counter_.reset();
+	}
+
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(ConvertTest, StringToVector)
+{
+	std::string s1(1000, 'a');
+	const char* data = s1.data();
+	const auto capacity = s1.capacity();
+
+	counter_.reset();
+	auto v1 = bt::to_vector(std::move(s1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	static_assert(std::is_same_v<decltype(v1), std::vector<char>>);
+	EXPECT_EQ(v1.data(), data);
+	EXPECT_EQ(v1.size(), 1000);
+	EXPECT_EQ(v1.capacity(), capacity + 1);
+	EXPECT_EQ(v1[999], 'a');
+	EXPECT_TRUE(s1.empty());
+}
+
+TEST_F(ConvertTest, SmallStringToVector)
+{
+	auto v1 = bt::to_vector(std::u16string{u"abc"});
+	static_assert(std::is_same_v<decltype(v1), std::vector<char16_t>>);
+	EXPECT_EQ(v1, (std::vector<char16_t>{u'a', u'b', u'c'}));
+}
+
+TEST_F(ConvertTest, StringToByteVector)
+{
+	std::string s1(100, 'a');
+	const char* data = s1.data();
+
+	auto v1 = bt::to_vector<std::byte>(std::move(s1));
+	static_assert(std::is_same_v<decltype(v1), std::vector<std::byte>>);
+	EXPECT_EQ(static_cast<const void*>(v1.data()), data);
+	EXPECT_EQ(v1[0], std::byte{'a'});
+}
+
+TEST_F(ConvertTest, VectorToString)
+{
+	std::vector<char> v1;
+	v1.reserve(1000);
+	v1.assign(500, 'a');
+	const char* data = v1.data();
+
+	counter_.reset();
+	auto s1 = bt::to_string(std::move(v1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	static_assert(std::is_same_v<decltype(s1), std::string>);
+	EXPECT_EQ(s1.data(), data);
+	EXPECT_EQ(s1, std::string(500, 'a'));
+	EXPECT_EQ(s1.c_str()[500], '\0');
+	EXPECT_EQ(v1.data(), nullptr);
+}
+
+TEST_F(ConvertTest, FullVectorToString)
+{
+	// No room for the null terminator, so the vector is copied
+	std::vector<char> v1(100, 'a');
+	v1.shrink_to_fit();
+	ASSERT_EQ(v1.size(), v1.capacity());
+
+	counter_.reset();
+	auto s1 = bt::to_string(std::move(v1));
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+	BYTES_EXPECT_GE(s1.capacity() + 1);
+	EXPECT_EQ(s1, std::string(100, 'a'));
+}
+
+TEST_F(ConvertTest, ByteVectorToString)
+{
+	std::vector<std::byte> v1;
+	v1.reserve(64);
+	v1.resize(32, std::byte{'x'});
+	const void* data = v1.data();
+
+	auto s1 = bt::to_string(std::move(v1));
+	static_assert(std::is_same_v<decltype(s1), std::string>);
+	EXPECT_EQ(static_cast<const void*>(s1.data()), data);
+	EXPECT_EQ(s1, std::string(32, 'x'));
+
+	auto s2 = bt::to_string<char8_t>(std::vector<unsigned char>(4, 'y'));
+	static_assert(std::is_same_v<decltype(s2), std::u8string>);
+	EXPECT_TRUE(s2 == u8"yyyy");
+}
+
+TEST_F(ConvertTest, RoundTrip)
+{
+	std::string s1(1000, 'a');
+	const char* data = s1.data();
+
+	auto v1 = bt::to_vector(std::move(s1));
+	v1.back() = 'b';
+
+	// The string's null terminator slot is still spare capacity
+	counter_.reset();
+	auto s2 = bt::to_string(std::move(v1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(s2.data(), data);
+	EXPECT_EQ(s2.size(), 1000);
+	EXPECT_EQ(s2.back(), 'b');
+}
@@ -0,0 +1,159 @@
+/*
+ * deque_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/deque.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for stealing deque blocks
+class DequeTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+namespace {
+
+template<typename T, typename Alloc>
+auto flatten(const bt::segment_list<T, Alloc>& list) -> std::vector<T>
+{
+	std::vector<T> output;
+	for (const auto& segment : list) {
+		output.insert(output.end(), segment.data, segment.data + segment.size);
+	}
+	return output;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////
+
+TEST_F(DequeTest, Chars)
+{
+	auto d1 = std::deque<char>{};
+	for (int i = 0; i < 10000; ++i) { d1.push_back(static_cast<char>('a' + i % 26)); }
+	for (int i = 0; i < 100; ++i) { d1.push_front('z'); }
+	d1.pop_back();
+
+	const auto expected = std::vector<char>(d1.begin(), d1.end());
+	const char* first = &d1.front();
+	const char* last = &d1.back();
+
+	counter_.reset();
+	auto list = bt::steal_segments(std::move(d1));
+	EXPECT_LT(counter_.bytesAllocated(), expected.size()); // no elements are copied
+
+	EXPECT_TRUE(d1.empty());
+	EXPECT_GT(list.size(), 1);
+	EXPECT_EQ(list.total_size(), expected.size());
+	EXPECT_EQ(list[0].data, first);
+	EXPECT_EQ(list[list.size() - 1].data + list[list.size() - 1].size - 1, last);
+
+	for (std::size_t i = 1; i + 1 < list.size(); ++i) {
+		EXPECT_EQ(list[i].size, list.block_capacity());
+	}
+
+	EXPECT_EQ(flatten(list), expected);
+
+	// The deque is still usable
+	d1.push_back('a');
+	EXPECT_EQ(d1.size(), 1);
+
+	const auto blocks = list.size();
+	counter_.reset();
+	list.reset();
+	DEALLOC_EXPECT_EQ(blocks + 1);
+	EXPECT_TRUE(list.empty());
+}
+
+TEST_F(DequeTest, Empty)
+{
+	auto d1 = std::deque<int>{};
+	auto list = bt::steal_segments(std::move(d1));
+	EXPECT_TRUE(list.empty());
+	EXPECT_EQ(list.total_size(), 0);
+	EXPECT_EQ(list.begin(), list.end());
+
+	// Emptied by popping, so it may still hold a block
+	auto d2 = std::deque<int>{1, 2, 3};
+	d2.pop_front();
+	d2.pop_front();
+	d2.pop_front();
+	list = bt::steal_segments(std::move(d2));
+	EXPECT_TRUE(list.empty());
+}
+
+TEST_F(DequeTest, SingleBlock)
+{
+	auto d1 = std::deque<std::int64_t>{-1, 0, 1, 2};
+	d1.pop_front();
+	d1.push_back(3);
+	const auto* first = &d1.front();
+
+	auto list = bt::steal_segments(std::move(d1));
+	ASSERT_EQ(list.size(), 1);
+	EXPECT_EQ(list[0].data, first);
+	EXPECT_EQ(list[0].size, 4);
+	EXPECT_EQ(flatten(list), (std::vector<std::int64_t>{0, 1, 2, 3}));
+}
+
+TEST_F(DequeTest, NonTrivial)
+{
+	const auto large = std::string(100, 'a');
+	auto d1 = std::deque<std::string>{};
+	for (int i = 0; i < 100; ++i) {
+		d1.push_back(large);
+		d1.push_front(std::to_string(i));
+	}
+	const auto expected = std::vector<std::string>(d1.begin(), d1.end());
+
+	auto list = bt::steal_segments(std::move(d1));
+	EXPECT_EQ(list.total_size(), 200);
+	EXPECT_EQ(flatten(list), expected);
+
+	// The large strings are destroyed along with the blocks
+	const auto blocks = list.size();
+	counter_.reset();
+	list.reset();
+	DEALLOC_EXPECT_EQ(blocks + 1 + 100);
+}
+
+#if __has_include(<sys/uio.h>)
+TEST_F(DequeTest, Iovecs)
+{
+	auto d1 = std::deque<std::uint32_t>(3000, 7);
+	auto list = bt::steal_segments(std::move(d1));
+
+	const auto iovecs = list.to_iovecs();
+	ASSERT_EQ(iovecs.size(), list.size());
+
+	std::size_t bytes = 0;
+	for (std::size_t i = 0; i < iovecs.size(); ++i) {
+		EXPECT_EQ(iovecs[i].iov_base, list[i].data);
+		EXPECT_EQ(iovecs[i].iov_len, list[i].size * sizeof(std::uint32_t));
+		bytes += iovecs[i].iov_len;
+	}
+	EXPECT_EQ(bytes, 3000 * sizeof(std::uint32_t));
+}
+#endif
@@ -0,0 +1,124 @@
+/*
+ * dlpack_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/dlpack.hh>
+#include <bufferthief/malloc_allocator.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for DLPack exports
+class DLPackTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(DLPackTest, Float2D)
+{
+	auto v1 = std::vector<float>(12, 0.5f);
+	v1[11] = 2.f;
+	const auto* data = v1.data();
+
+	counter_.reset();
+	DLManagedTensor* managed = bt::to_dlpack(std::move(v1), {3, 4});
+	ALLOC_EXPECT_EQ(1); // context and shape
+	EXPECT_EQ(v1.data(), nullptr);
+
+	const DLTensor& tensor = managed->dl_tensor;
+	EXPECT_EQ(tensor.data, data);
+	EXPECT_EQ(tensor.device.device_type, kDLCPU);
+	EXPECT_EQ(tensor.device.device_id, 0);
+	EXPECT_EQ(tensor.ndim, 2);
+	EXPECT_EQ(tensor.shape[0], 3);
+	EXPECT_EQ(tensor.shape[1], 4);
+	EXPECT_EQ(tensor.strides, nullptr);
+	EXPECT_EQ(tensor.byte_offset, 0);
+	EXPECT_EQ(tensor.dtype.code, kDLFloat);
+	EXPECT_EQ(tensor.dtype.bits, 32);
+	EXPECT_EQ(tensor.dtype.lanes, 1);
+	EXPECT_EQ(static_cast<const float*>(tensor.data)[11], 2.f);
+
+	managed->deleter(managed);
+	DEALLOC_EXPECT_EQ(2);
+}
+
+TEST_F(DLPackTest, Integers)
+{
+	auto v1 = std::vector<std::int16_t>{1, 2, 3};
+	DLManagedTensor* managed = bt::to_dlpack(std::move(v1));
+	EXPECT_EQ(managed->dl_tensor.ndim, 1);
+	EXPECT_EQ(managed->dl_tensor.shape[0], 3);
+	EXPECT_EQ(managed->dl_tensor.dtype.code, kDLInt);
+	EXPECT_EQ(managed->dl_tensor.dtype.bits, 16);
+	managed->deleter(managed);
+
+	auto v2 = std::vector<std::uint64_t>{};
+	managed = bt::to_dlpack(std::move(v2));
+	EXPECT_EQ(managed->dl_tensor.shape[0], 0);
+	EXPECT_EQ(managed->dl_tensor.dtype.code, kDLUInt);
+	EXPECT_EQ(managed->dl_tensor.dtype.bits, 64);
+	managed->deleter(managed);
+}
+
+TEST_F(DLPackTest, CustomAllocator)
+{
+	auto v1 = std::vector<double, bt::malloc_allocator<double>>(8, 1.0);
+
+	counter_.reset();
+	DLManagedTensor* managed = bt::to_dlpack(std::move(v1), {2, 2, 2});
+	EXPECT_EQ(managed->dl_tensor.ndim, 3);
+	managed->deleter(managed);
+
+	// The buffer is freed with std::free, not operator delete
+	DEALLOC_EXPECT_EQ(1);
+}
+
+TEST_F(DLPackTest, ShapeMismatch)
+{
+	auto v1 = std::vector<double>(6);
+	const auto* data = v1.data();
+
+	EXPECT_THROW(bt::to_dlpack(std::move(v1), {4, 2}), std::invalid_argument);
+	EXPECT_THROW(bt::to_dlpack(std::move(v1), {-2, -3}), std::invalid_argument);
+	EXPECT_EQ(v1.data(), data);
+	EXPECT_EQ(v1.size(), 6);
+}
+
+TEST_F(DLPackTest, ShapeOverflow)
+{
+	auto v1 = std::vector<double>(6);
+	const auto* data = v1.data();
+
+	// The product wraps around to 6 in 64 bits
+	EXPECT_THROW(bt::to_dlpack(std::move(v1), {11, 1676976733973595602}), std::invalid_argument);
+	EXPECT_EQ(v1.data(), data);
+	EXPECT_EQ(v1.size(), 6);
+
+	// A zero extent makes the shape empty, even when the other extents overflow
+	auto v2 = std::vector<double>{};
+	DLManagedTensor* managed = bt::to_dlpack(std::move(v2), {std::int64_t{1} << 40, std::int64_t{1} << 40, 0});
+	EXPECT_EQ(managed->dl_tensor.ndim, 3);
+	managed->deleter(managed);
+}
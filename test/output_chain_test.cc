@@ -0,0 +1,143 @@
+/*
+ * output_chain_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <bufferthief/output_chain.hh>
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+namespace {
+
+//! @returns everything written to a temporary file
+auto readAll(std::FILE* file) -> std::string
+{
+	std::string result;
+	std::rewind(file);
+	char chunk[4096];
+	while (const auto count = std::fread(chunk, 1, sizeof(chunk), file)) {
+		result.append(chunk, count);
+	}
+	return result;
+}
+
+} // namespace
+
+TEST(OutputChainTest, WriteFragments)
+{
+	std::FILE* file = std::tmpfile();
+	ASSERT_NE(file, nullptr);
+
+	bt::output_chain chain;
+	chain.append(std::string("GET "));
+	chain.append(std::string("/index\r\n"));
+	chain.append(std::string(100, 'a'));
+	chain.append(std::vector<char>{'!', '\n'});
+	chain.append(std::string{});
+
+	// Adjacent small strings share a range
+	EXPECT_EQ(chain.ranges(), 3);
+	EXPECT_EQ(chain.size(), 4 + 8 + 100 + 2);
+
+	EXPECT_EQ(chain.flush(fileno(file)), 114);
+	EXPECT_TRUE(chain.empty());
+	EXPECT_EQ(chain.ranges(), 0);
+
+	EXPECT_EQ(readAll(file), "GET /index\r\n" + std::string(100, 'a') + "!\n");
+	std::fclose(file);
+}
+
+TEST(OutputChainTest, ManyRanges)
+{
+	std::FILE* file = std::tmpfile();
+	ASSERT_NE(file, nullptr);
+
+	// More ranges than a single writev call accepts
+	bt::output_chain chain;
+	std::string expected;
+	const auto count = bt::output_chain::max_ranges_per_write * 2 + 10;
+	for (std::size_t i = 0; i < count; ++i) {
+		auto fragment = std::string(40, static_cast<char>('a' + i % 26));
+		expected += fragment;
+		chain.append(std::move(fragment));
+		chain.append(std::u16string(1, u'-'));
+		expected.append(reinterpret_cast<const char*>(u"-"), 2);
+	}
+	EXPECT_EQ(chain.ranges(), 2 * count);
+
+	EXPECT_EQ(chain.flush(fileno(file)), expected.size());
+	EXPECT_EQ(readAll(file), expected);
+	std::fclose(file);
+}
+
+TEST(OutputChainTest, PartialWrites)
+{
+	int fds[2];
+	ASSERT_EQ(::pipe(fds), 0);
+	ASSERT_EQ(::fcntl(fds[1], F_SETFL, O_NONBLOCK), 0);
+
+	// More than the pipe can hold, so flush() stops when the pipe is full
+	bt::output_chain chain;
+	std::string expected;
+	for (int i = 0; i < 64; ++i) {
+		auto fragment = std::string(10000, static_cast<char>('a' + i % 26));
+		expected += fragment;
+		chain.append(std::move(fragment));
+	}
+
+	std::string received;
+	char chunk[4096];
+	while (!chain.empty()) {
+		const auto before = chain.size();
+		const auto written = chain.flush(fds[1]);
+		EXPECT_EQ(chain.size(), before - written);
+
+		while (received.size() < expected.size() - chain.size()) {
+			const auto count = ::read(fds[0], chunk, sizeof(chunk));
+			ASSERT_GT(count, 0);
+			received.append(chunk, static_cast<std::size_t>(count));
+		}
+	}
+	EXPECT_EQ(received, expected);
+
+	::close(fds[0]);
+	::close(fds[1]);
+}
+
+TEST(OutputChainTest, Clear)
+{
+	// Unwritten buffers are released (checked with sanitizers)
+	bt::output_chain chain;
+	chain.append(std::string(100, 'a'));
+	chain.append(std::string("b"));
+	chain.append(std::vector<std::uint32_t>(10));
+
+	auto moved = std::move(chain);
+	EXPECT_TRUE(chain.empty());
+	EXPECT_EQ(moved.size(), 100 + 1 + 40);
+
+	moved.clear();
+	EXPECT_TRUE(moved.empty());
+	moved.append(std::string("c"));
+	EXPECT_EQ(moved.ranges(), 1);
+}
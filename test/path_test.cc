@@ -0,0 +1,77 @@
+/*
+ * path_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/path.hh>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+namespace fs = std::filesystem;
+
+//! Test fixture for stealing path strings
+class PathTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(PathTest, LongPath)
+{
+	auto p1 = fs::path{"/var/lib/indexer/shards/0001/documents/report.txt"};
+	const auto expected = p1.native();
+	const auto* data = p1.c_str();
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(p1));
+	ALLOC_EXPECT_EQ(0);
+
+	EXPECT_EQ(b1.data(), data);
+	EXPECT_EQ(fs::path::string_type(b1.data(), b1.size()), expected);
+	EXPECT_EQ(b1.data()[b1.size()], fs::path::value_type());
+
+	// Left validly empty, including its components
+	EXPECT_TRUE(p1.empty());
+	EXPECT_EQ(p1.begin(), p1.end());
+	EXPECT_FALSE(p1.has_filename());
+
+	p1 /= "a";
+	p1 /= "b";
+	EXPECT_EQ(std::distance(p1.begin(), p1.end()), 2);
+}
+
+TEST_F(PathTest, ShortPath)
+{
+	auto p1 = fs::path{"a/b"};
+	auto b1 = bt::steal(std::move(p1));
+	EXPECT_EQ(fs::path::string_type(b1.data(), b1.size()), fs::path("a/b").native());
+	EXPECT_TRUE(p1.empty());
+	EXPECT_EQ(p1.begin(), p1.end());
+}
+
+TEST_F(PathTest, EmptyPath)
+{
+	auto p1 = fs::path{};
+	auto b1 = bt::steal(std::move(p1));
+	EXPECT_EQ(b1.size(), 0);
+	EXPECT_TRUE(p1.empty());
+}
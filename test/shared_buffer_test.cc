@@ -0,0 +1,126 @@
+/*
+ * shared_buffer_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/shared_buffer.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for shared buffers
+class SharedBufferTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(SharedBufferTest, StringWithSlack)
+{
+	const auto expected = std::string(100, 'a');
+	auto s1 = expected;
+	s1.reserve(200);
+	const char* data = s1.data();
+
+	counter_.reset();
+	auto b1 = bt::steal_shared(std::move(s1));
+	auto b2 = b1;
+	auto b3 = b2;
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	EXPECT_TRUE(b1.shares_storage());
+	EXPECT_EQ(b3.get(), data);
+	EXPECT_EQ(b3.use_count(), 3);
+	EXPECT_EQ(std::string_view(b3.data(), b3.size()), expected);
+	EXPECT_EQ(b3[100], '\0');
+
+	b1.reset();
+	b2 = bt::shared_buffer<char>{};
+	EXPECT_EQ(b3.use_count(), 1);
+	DEALLOC_EXPECT_EQ(0);
+
+	b3.reset();
+	EXPECT_EQ(b3, nullptr);
+	DEALLOC_EXPECT_EQ(1);
+}
+
+TEST_F(SharedBufferTest, VectorWithoutSlack)
+{
+	// No spare capacity, so the count is allocated separately
+	auto v1 = std::vector<std::int64_t>(10, 7);
+	v1.shrink_to_fit();
+	ASSERT_EQ(v1.capacity(), 10);
+
+	counter_.reset();
+	auto b1 = bt::steal_shared(std::move(v1));
+	ALLOC_EXPECT_EQ(1);
+	EXPECT_FALSE(b1.shares_storage());
+	EXPECT_EQ(b1.size(), 10);
+	EXPECT_EQ(b1[9], 7);
+
+	auto b2 = std::move(b1);
+	EXPECT_EQ(b1, nullptr);
+	EXPECT_EQ(b2.use_count(), 1);
+
+	b2.reset();
+	DEALLOC_EXPECT_EQ(2);
+}
+
+TEST_F(SharedBufferTest, NonTrivial)
+{
+	std::vector<std::string> v1;
+	v1.reserve(8);
+	v1.emplace_back(100, 'a');
+	v1.emplace_back(100, 'b');
+
+	counter_.reset();
+	{
+		auto b1 = bt::steal_shared(std::move(v1));
+		EXPECT_TRUE(b1.shares_storage());
+		EXPECT_EQ(b1[1].front(), 'b');
+		ALLOC_EXPECT_EQ(0);
+	}
+	// The elements are destroyed along with the buffer
+	DEALLOC_EXPECT_EQ(3);
+}
+
+TEST_F(SharedBufferTest, Threads)
+{
+	auto b1 = bt::steal_shared(std::vector<std::uint8_t>(1000, 1));
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 8; ++i) {
+		threads.emplace_back([copy = b1]() mutable {
+			for (int j = 0; j < 1000; ++j) {
+				auto another = copy;
+				EXPECT_EQ(another[999], 1);
+			}
+			copy.reset();
+		});
+	}
+	for (auto& thread : threads) { thread.join(); }
+
+	EXPECT_EQ(b1.use_count(), 1);
+}
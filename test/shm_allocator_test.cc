@@ -0,0 +1,161 @@
+/*
+ * shm_allocator_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if defined(BT_COPY_BUFFERS)
+#error "These tests require stealing to be enabled"
+#endif
+
+#include <bufferthief/shm_allocator.hh>
+#include <bufferthief/string.hh>
+#include <bufferthief/vector.hh>
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+TEST(ShmAllocatorTest, AllocateAndDeallocate)
+{
+	bt::shm_arena arena{1024};
+	EXPECT_EQ(arena.capacity(), 1024);
+	EXPECT_EQ(arena.used(), 0);
+
+	void* a = arena.allocate(100);
+	void* b = arena.allocate(1);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % bt::shm_arena::granularity, 0);
+	EXPECT_EQ(arena.used(), 128 + 64);
+
+	// 832 bytes remain
+	EXPECT_THROW(arena.allocate(900), std::bad_alloc);
+
+	arena.deallocate(a, 100);
+	arena.deallocate(b, 1);
+	EXPECT_EQ(arena.used(), 0);
+
+	// Freed ranges are merged and reused
+	void* c = arena.allocate(1024);
+	EXPECT_EQ(c, a);
+	arena.deallocate(c, 1024);
+}
+
+TEST(ShmAllocatorTest, DefaultAllocatorCannotAllocate)
+{
+	bt::shm_allocator<int> alloc;
+	EXPECT_THROW(alloc.allocate(1), std::bad_alloc);
+}
+
+TEST(ShmAllocatorTest, StealString)
+{
+	bt::shm_arena arena{4096};
+	{
+		auto str = bt::shm_string{arena};
+		str.assign("This string is too long for the small string optimization");
+
+		const auto* data = str.data();
+		auto handle = bt::to_shm_handle(bt::steal(std::move(str)));
+		EXPECT_EQ(handle.segment, arena.segment());
+		EXPECT_EQ(handle.length, 57);
+		EXPECT_GT(handle.capacity, handle.length);
+		EXPECT_EQ(arena.data(handle), data);
+
+		// The container no longer owns the buffer
+		EXPECT_GT(arena.used(), 0);
+		arena.release(handle);
+	}
+	EXPECT_EQ(arena.used(), 0);
+}
+
+TEST(ShmAllocatorTest, StealEmptyVector)
+{
+	bt::shm_arena arena{4096};
+	auto handle = bt::to_shm_handle(bt::steal(bt::shm_vector<int>{arena}));
+	EXPECT_EQ(handle.capacity, 0);
+	EXPECT_EQ(arena.data(handle), nullptr);
+	arena.release(handle);
+	EXPECT_EQ(arena.used(), 0);
+}
+
+TEST(ShmAllocatorTest, HandOffToOtherProcess)
+{
+	bt::shm_arena arena{1 << 16};
+
+	auto str = bt::shm_string{arena};
+	str.assign(200, 'x');
+	auto vec = bt::shm_vector<std::int32_t>{arena};
+	for (std::int32_t i = 0; i < 1000; ++i) {
+		vec.push_back(i);
+	}
+
+	const bt::shm_handle handles[] = {
+		bt::to_shm_handle(bt::steal(std::move(str))),
+		bt::to_shm_handle(bt::steal(std::move(vec)))
+	};
+	ASSERT_GT(arena.used(), 0);
+
+	int fds[2];
+	ASSERT_EQ(::pipe(fds), 0);
+
+	const ::pid_t child = ::fork();
+	ASSERT_GE(child, 0);
+	if (child == 0) {
+		::close(fds[1]);
+
+		bt::shm_handle received[2];
+		if (::read(fds[0], received, sizeof(received)) != static_cast<::ssize_t>(sizeof(received))) { ::_exit(1); }
+
+		auto other = bt::shm_arena::attach(received[0].segment);
+
+		const auto text = std::string_view{static_cast<const char*>(other.data(received[0])), received[0].length};
+		if (text != std::string_view{std::string(200, 'x')}) { ::_exit(2); }
+
+		const auto* numbers = static_cast<const std::int32_t*>(other.data(received[1]));
+		if (received[1].length != 1000 * sizeof(std::int32_t)) { ::_exit(3); }
+		for (std::int32_t i = 0; i < 1000; ++i) {
+			if (numbers[i] != i) { ::_exit(4); }
+		}
+
+		other.release(received[0]);
+		other.release(received[1]);
+		::_exit(0);
+	}
+
+	::close(fds[0]);
+	ASSERT_EQ(::write(fds[1], handles, sizeof(handles)), static_cast<::ssize_t>(sizeof(handles)));
+	::close(fds[1]);
+
+	int status = 0;
+	ASSERT_EQ(::waitpid(child, &status, 0), child);
+	ASSERT_TRUE(WIFEXITED(status));
+	EXPECT_EQ(WEXITSTATUS(status), 0);
+
+	// The child released both buffers through its own mapping
+	EXPECT_EQ(arena.used(), 0);
+}
+
+TEST(ShmAllocatorTest, AttachMissingSegment)
+{
+	std::uint64_t segment;
+	{
+		bt::shm_arena arena{64};
+		segment = arena.segment();
+	}
+
+	// The creator removed the segment
+	EXPECT_THROW(bt::shm_arena::attach(segment), std::system_error);
+}
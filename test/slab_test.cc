@@ -0,0 +1,186 @@
+/*
+ * slab_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/slab.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+namespace {
+
+auto same_page(const void* a, const void* b) -> bool
+{
+	const auto mask = ~(bt::detail::slab_page_size - 1);
+	return (reinterpret_cast<std::uintptr_t>(a) & mask) == (reinterpret_cast<std::uintptr_t>(b) & mask);
+}
+
+//! Allocates from the slab while its thread exits, after the thread's pages are detached
+struct LateAllocation
+{
+	bt::buffer<char, bt::slab_allocator<char>>* out = nullptr;
+
+	~LateAllocation()
+	{
+		if (out) { *out = bt::steal(std::string("late"), bt::use_slab); }
+	}
+};
+
+thread_local LateAllocation late_allocation;
+
+} // namespace
+
+//! Test fixture for the slab allocator
+class SlabTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		counter_.reset();
+	}
+
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(SlabTest, StealSmall)
+{
+	const auto size = bt::small_string_max_size<char>();
+	auto s1 = std::string(size, 'a');
+	auto s2 = std::string("b");
+
+	auto b1 = bt::steal(std::move(s1), bt::use_slab);
+	auto b2 = bt::steal(std::move(s2), bt::use_slab);
+	EXPECT_EQ(b1.size(), size);
+	EXPECT_EQ(b1.capacity(), bt::slab_allocator<char>::slot_size);
+	EXPECT_EQ(std::string_view(b1.get(), b1.size()), std::string(size, 'a'));
+	EXPECT_EQ(b1.get()[size], '\0');
+	EXPECT_EQ(std::string_view(b2.get(), b2.size()), "b");
+
+	// Both copies come from this thread's slab
+	EXPECT_TRUE(same_page(b1.get(), b2.get()));
+
+	// A freed block is reused by the next copy
+	const char* data = b2.get();
+	b2.reset();
+	counter_.reset();
+	auto b3 = bt::steal(std::string("c"), bt::use_slab);
+	EXPECT_EQ(b3.get(), data);
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+}
+
+TEST_F(SlabTest, StealLong)
+{
+	auto s1 = std::u16string(100, u'a');
+	const char16_t* data = s1.data();
+	const auto capacity = s1.capacity();
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(s1), bt::use_slab);
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(b1.get(), data);
+	EXPECT_EQ(b1.size(), 100);
+	EXPECT_EQ(b1.capacity(), capacity + 1);
+	EXPECT_TRUE(s1.empty());
+}
+
+TEST_F(SlabTest, ManyPages)
+{
+	// Enough blocks to fill several pages
+	const auto count = 4 * bt::detail::slab_page_size / bt::slab_allocator<char32_t>::slot_size;
+
+	std::vector<bt::buffer<char32_t, bt::slab_allocator<char32_t>>> buffers;
+	for (std::size_t i = 0; i < count; ++i) {
+		buffers.push_back(bt::steal(std::u32string(1, U'a'), bt::use_slab));
+	}
+
+	for (const auto& b : buffers) {
+		EXPECT_EQ(b.get()[0], U'a');
+		EXPECT_EQ(b.get()[1], U'\0');
+	}
+}
+
+TEST_F(SlabTest, RemoteFree)
+{
+	auto b1 = bt::steal(std::string("a"), bt::use_slab);
+	const char* data = b1.get();
+
+	std::thread consumer{[b = std::move(b1)]() mutable { b.reset(); }};
+	consumer.join();
+
+	// The owner takes back blocks freed by other threads once its page runs out
+	std::vector<bt::buffer<char, bt::slab_allocator<char>>> buffers;
+	bool reused = false;
+	for (std::size_t i = 0; i < bt::detail::slab_page_size && !reused; ++i) {
+		buffers.push_back(bt::steal(std::string("b"), bt::use_slab));
+		reused = buffers.back().get() == data;
+	}
+	EXPECT_TRUE(reused);
+}
+
+TEST_F(SlabTest, OwnerExits)
+{
+	// Blocks outlive the thread which allocated them, and the last one frees the page
+	std::vector<bt::buffer<wchar_t, bt::slab_allocator<wchar_t>>> buffers;
+
+	std::thread producer{[&] {
+		for (int i = 0; i < 3; ++i) {
+			buffers.push_back(bt::steal(std::wstring(1, L'a'), bt::use_slab));
+		}
+		buffers.erase(buffers.begin());
+	}};
+	producer.join();
+
+	ASSERT_EQ(buffers.size(), 2);
+	EXPECT_EQ(buffers[0].get()[0], L'a');
+	buffers.clear();
+}
+
+TEST_F(SlabTest, OrphanFreedByNewThread)
+{
+	bt::buffer<char, bt::slab_allocator<char>> orphan;
+
+	std::thread producer{[&] {
+		// Constructed before the slab's guard, so it is destroyed after the pages are detached
+		late_allocation.out = &orphan;
+		auto b = bt::steal(std::string("a"), bt::use_slab);
+	}};
+	producer.join();
+	ASSERT_NE(orphan, nullptr);
+	EXPECT_EQ(std::string_view(orphan.get(), orphan.size()), "late");
+
+	// A thread which never allocated from the slab frees the block, and with it the orphan's page
+	std::size_t deallocations = 0;
+	std::thread consumer{[&] {
+		AllocationCounter counter;
+		orphan.reset();
+		deallocations = counter.deallocations();
+	}};
+	consumer.join();
+#if TEST_ALLOCATIONS == 1
+	EXPECT_EQ(deallocations, 1);
+#endif
+}
@@ -0,0 +1,136 @@
+/*
+ * sstream_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/sstream.hh>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+namespace {
+
+template<typename CharT>
+auto view(const bt::buffer<CharT>& input) -> std::basic_string_view<CharT>
+{
+	return {input.data(), input.size()};
+}
+
+} // namespace
+
+//! Test fixture for string streams
+class SstreamTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		counter_.reset();
+	}
+
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(SstreamTest, StealOstringstream)
+{
+	std::ostringstream oss;
+	for (int i = 0; i < 1000; ++i) {
+		oss << i << ',';
+	}
+	const auto expected = oss.str();
+	const char* data = oss.rdbuf()->view().data();
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(oss));
+	EXPECT_EQ(view(b1), expected);
+	EXPECT_EQ(b1.data()[b1.size()], '\0');
+#if !defined(_MSC_VER)
+	EXPECT_EQ(b1.data(), data);
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+#endif
+
+	// The stream is empty and may be written to again
+	EXPECT_TRUE(oss.str().empty());
+	oss << "abc";
+	EXPECT_EQ(oss.str(), "abc");
+}
+
+TEST_F(SstreamTest, StealSmall)
+{
+	std::ostringstream oss;
+	oss << "abc";
+
+	// The small string is copied into a buffer of its own
+	counter_.reset();
+	auto b1 = bt::steal(std::move(oss));
+	EXPECT_EQ(view(b1), "abc");
+	EXPECT_EQ(b1.capacity(), 4);
+	ALLOC_EXPECT_EQ(1);
+	BYTES_EXPECT_EQ(4);
+}
+
+TEST_F(SstreamTest, StealEmpty)
+{
+	auto b1 = bt::steal(std::ostringstream{});
+	EXPECT_TRUE(b1.empty());
+	EXPECT_EQ(b1.data()[0], '\0');
+}
+
+TEST_F(SstreamTest, StealOverwritten)
+{
+	// The put position is behind the end of the written sequence
+	std::stringstream ss;
+	ss << std::string(100, 'a');
+	ss.seekp(0);
+	ss << 'b';
+	ASSERT_EQ(ss.str().size(), 100);
+
+	auto b1 = bt::steal(std::move(ss));
+	EXPECT_EQ(view(b1), 'b' + std::string(99, 'a'));
+}
+
+TEST_F(SstreamTest, StealInputMode)
+{
+	std::stringbuf sb{std::string(100, 'a'), std::ios_base::in};
+
+	auto b1 = bt::steal(std::move(sb));
+	EXPECT_EQ(view(b1), std::string(100, 'a'));
+	EXPECT_TRUE(sb.str().empty());
+}
+
+TEST_F(SstreamTest, StealAppendMode)
+{
+	std::ostringstream oss{std::string(100, 'a'), std::ios_base::app};
+	oss << "bc";
+
+	auto b1 = bt::steal(std::move(oss));
+	EXPECT_EQ(view(b1), std::string(100, 'a') + "bc");
+}
+
+TEST_F(SstreamTest, StealWide)
+{
+	std::wostringstream oss;
+	oss << std::wstring(100, L'x') << 42;
+
+	auto b1 = bt::steal(std::move(*oss.rdbuf()));
+	EXPECT_EQ(view(b1), std::wstring(100, L'x') + L"42");
+}
@@ -0,0 +1,100 @@
+/*
+ * stats_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <bufferthief/stats.hh>
+#include <bufferthief/string.hh>
+#include <bufferthief/vector.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for the steal and copy counters
+class StatsTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		bt::stats().reset();
+	}
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(StatsTest, SizeClasses)
+{
+	EXPECT_EQ(bt::detail::stats_size_class(0), 0);
+	EXPECT_EQ(bt::detail::stats_size_class(1), 1);
+	EXPECT_EQ(bt::detail::stats_size_class(101), 7);
+	EXPECT_EQ(bt::detail::stats_size_class(128), 8);
+	EXPECT_EQ(bt::detail::stats_size_class(~std::size_t{0}), 64);
+}
+
+TEST_F(StatsTest, Strings)
+{
+	auto b1 = bt::steal(std::string(100, 'a'));
+	auto b2 = bt::steal(std::string(2, 'b'));
+	auto b3 = bt::try_steal(*std::make_unique<std::string>(3, 'c'));
+
+	const auto s = bt::stats().snapshot();
+	EXPECT_EQ(s.string_steals, 1);
+	EXPECT_EQ(s.string_copies, 1);
+	EXPECT_EQ(s.vector_steals, 0);
+	EXPECT_EQ(s.bytes_stolen, 101);
+	EXPECT_EQ(s.bytes_copied, 3);
+	EXPECT_EQ(s.stolen_sizes[bt::detail::stats_size_class(101)], 1);
+	EXPECT_EQ(s.copied_sizes[bt::detail::stats_size_class(3)], 1);
+}
+
+TEST_F(StatsTest, Vectors)
+{
+	auto b1 = bt::steal(std::vector<std::int32_t>(10));
+	auto b2 = bt::steal(std::vector<std::int32_t>{});
+
+	std::vector<std::int32_t> v3(10);
+	v3.reserve(1000);
+	auto b3 = bt::steal(std::move(v3), bt::copy_if_slack_exceeds_ratio{0.5});
+
+	const auto s = bt::stats().snapshot();
+	EXPECT_EQ(s.vector_steals, 1);
+	EXPECT_EQ(s.vector_copies, 1);
+	EXPECT_EQ(s.string_steals, 0);
+	EXPECT_EQ(s.bytes_stolen, 40);
+	EXPECT_EQ(s.bytes_copied, 40);
+}
+
+TEST_F(StatsTest, Threads)
+{
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 40; ++i) {
+		threads.emplace_back([] {
+			for (int j = 0; j < 100; ++j) {
+				auto b = bt::steal(std::string(100, 'a'));
+			}
+		});
+	}
+	for (auto& thread : threads) { thread.join(); }
+
+	EXPECT_EQ(bt::stats().snapshot().string_steals, 4000);
+
+	bt::stats().reset();
+	EXPECT_EQ(bt::stats().snapshot().string_steals, 0);
+}
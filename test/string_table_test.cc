@@ -0,0 +1,125 @@
+/*
+ * string_table_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/string_table.hh>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for string tables
+class StringTableTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		counter_.reset();
+	}
+
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(StringTableTest, Empty)
+{
+	auto t1 = bt::steal_all(std::vector<std::string>{});
+	EXPECT_TRUE(t1.empty());
+	EXPECT_EQ(t1.data(), nullptr);
+
+	// The vector's buffer is still owned by the table
+	std::vector<std::string> v1;
+	v1.reserve(10);
+	counter_.reset();
+	auto t2 = bt::steal_all(std::move(v1));
+	EXPECT_TRUE(t2.empty());
+	EXPECT_EQ(v1.capacity(), 0);
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+}
+
+TEST_F(StringTableTest, Mixed)
+{
+	const auto small_max = bt::small_string_max_size<char>();
+
+	std::vector<std::string> v1;
+	v1.emplace_back("a");
+	v1.emplace_back(100, 'b');
+	v1.emplace_back("");
+	v1.emplace_back(small_max, 'c');
+	v1.emplace_back(small_max + 1, 'd');
+
+	const void* outer = v1.data();
+	const char* large1 = v1[1].data();
+	const char* large2 = v1[4].data();
+
+	// The small strings share one allocation with the lengths and capacities
+	counter_.reset();
+	auto t1 = bt::steal_all(std::move(v1));
+	EXPECT_TRUE(v1.empty());
+	EXPECT_EQ(v1.capacity(), 0);
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(0);
+	const auto packed = 2 + 1 + (small_max + 1);
+	BYTES_EXPECT_EQ((2 * 5 + (packed + sizeof(std::size_t) - 1) / sizeof(std::size_t)) * sizeof(std::size_t));
+
+	ASSERT_EQ(t1.size(), 5);
+	EXPECT_EQ(t1[0], "a");
+	EXPECT_EQ(t1[1], std::string(100, 'b'));
+	EXPECT_EQ(t1[2], "");
+	EXPECT_EQ(t1[3], std::string(small_max, 'c'));
+	EXPECT_EQ(t1[4], std::string(small_max + 1, 'd'));
+
+	// The pointer array reuses the vector's buffer, and large buffers are stolen
+	EXPECT_EQ(static_cast<const void*>(t1.data()), outer);
+	EXPECT_EQ(t1.data()[1], large1);
+	EXPECT_EQ(t1.data()[4], large2);
+
+	// Small strings are packed together and null-terminated
+	EXPECT_EQ(t1.data()[2], t1.data()[0] + 2);
+	EXPECT_EQ(t1.data()[3], t1.data()[2] + 1);
+	EXPECT_EQ(t1.data()[3][small_max], '\0');
+
+	EXPECT_EQ(t1.lengths()[1], 100);
+	EXPECT_EQ(t1.lengths()[2], 0);
+}
+
+TEST_F(StringTableTest, Char32)
+{
+	std::vector<std::u32string> v1(1000);
+	for (std::size_t i = 0; i < v1.size(); ++i) {
+		v1[i].assign(i % 10, U'x');
+	}
+
+	counter_.reset();
+	auto t1 = bt::steal_all(std::move(v1));
+	ASSERT_EQ(t1.size(), 1000);
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(0);
+	for (std::size_t i = 0; i < t1.size(); ++i) {
+		EXPECT_EQ(t1[i], std::u32string(i % 10, U'x'));
+	}
+
+	// Moved-from tables are empty
+	auto t2 = std::move(t1);
+	EXPECT_TRUE(t1.empty());
+	EXPECT_EQ(t2.size(), 1000);
+}
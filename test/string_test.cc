@@ -11,49 +11,28 @@
  * You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
+#include "allocation_counter.hh"
+
+#include <bufferthief/steal_result.hh>
 #include <bufferthief/string.hh>
 #include <gtest/gtest.h>
 
 #include <cstdlib>
 #include <stdexcept>
+#include <string_view>
 #include <iostream>
 #include <type_traits>
 #include <utility>
 
-/**
- * Whether to test allocation and deallocation counts
- *
- * With this on, tests fail for these cases:
- * - Windows/MSVC STL (Debug configuration only)
- * - Linux/Clang/libc++
- */
-#define TEST_ALLOCATIONS 0
+// libc++ 15 only provides <experimental/memory_resource>
+#if __has_include(<memory_resource>)
+#	include <memory_resource>
+#endif
 
 #if defined(BT_COPY_BUFFERS)
 #	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
 #endif
 
-namespace {
-
-auto allocations_ = 0;
-auto deallocations_ = 0;
-
-void resetAllocDealloc()
-{
-	allocations_ = 0;
-	deallocations_ = 0;
-}
-
-#if TEST_ALLOCATIONS == 1
-#	define ALLOC_EXPECT_EQ(x) EXPECT_EQ(allocations_, (x))
-#	define DEALLOC_EXPECT_EQ(x) EXPECT_EQ(deallocations_, (x))
-#else
-#	define ALLOC_EXPECT_EQ(x)
-#	define DEALLOC_EXPECT_EQ(x)
-#endif
-
-} // namespace
-
 //! Test fixture for strings
 class StringTest : public ::testing::Test
 {
@@ -63,13 +42,13 @@ public:
 
 	void SetUp() override
 	{
-		resetAllocDealloc();
+		counter_.reset();
 	}
 
 	void TearDown() override {}
 
 	template<typename CharT>
-	auto generateString(std::size_t length, std::size_t reserve = 0) const -> std::basic_string<CharT>
+	auto generateString(std::size_t length, std::size_t reserve = 0) -> std::basic_string<CharT>
 	{
 		std::basic_string<CharT> ret;
 		if (reserve > 0) {
@@ -92,25 +71,14 @@ public:
 			ret += getChar(i);
 		}
 
-		resetAllocDealloc();
+		counter_.reset();
 
 		return ret;
 	}
-};
 
-void* operator new(std::size_t n) noexcept(false)
-{
-	void* p = std::malloc(n);
-	if (!p) { throw std::bad_alloc{}; }
-	++allocations_;
-	return p;
-}
-
-void operator delete(void* p) noexcept
-{
-	std::free(p);
-	if (p) { ++deallocations_; }
-}
+protected:
+	AllocationCounter counter_;
+};
 
 ///////////////////////////////////////////////////
 
@@ -121,6 +89,7 @@ TEST_F(StringTest, StealCharEmpty)
 	EXPECT_EQ(s1[0], '\0');
 	ALLOC_EXPECT_EQ(1);
 	DEALLOC_EXPECT_EQ(0);
+	BYTES_EXPECT_EQ(1);
 
 	auto s2 = generateString<char>(0);
 	EXPECT_EQ(bt::uses_large_buffer(s2), false);
@@ -156,6 +125,7 @@ TEST_F(StringTest, StealCharSmallMax)
 	EXPECT_EQ(std::char_traits<char>::length(s1.get()), bt::small_string_max_size<char>());
 	ALLOC_EXPECT_EQ(1);
 	DEALLOC_EXPECT_EQ(0);
+	BYTES_EXPECT_EQ(bt::small_string_max_size<char>() + 1);
 
 	auto s2 = generateString<char>(bt::small_string_max_size<char>());
 	EXPECT_EQ(bt::uses_large_buffer(s2), false);
@@ -199,3 +169,330 @@ TEST_F(StringTest, StealCharLongMin2)
 	ALLOC_EXPECT_EQ(0);
 	DEALLOC_EXPECT_EQ(1);
 }
+
+TEST_F(StringTest, StealCharSizeAndCapacity)
+{
+	auto s1 = generateString<char>(bt::small_string_max_size<char>() + 1, 100);
+	const auto capacity = s1.capacity();
+
+	auto s2 = bt::steal(std::move(s1));
+	EXPECT_EQ(s2.size(), bt::small_string_max_size<char>() + 1);
+	EXPECT_EQ(s2.capacity(), capacity + 1);
+	EXPECT_EQ(s2[s2.size()], '\0');
+
+	auto s3 = bt::steal(generateString<char>(3));
+	EXPECT_EQ(s3.size(), 3);
+	EXPECT_EQ(s3.capacity(), 4);
+	EXPECT_EQ(s3[3], '\0');
+}
+
+TEST_F(StringTest, StealCharAppendInPlace)
+{
+	auto s1 = bt::steal(generateString<char>(bt::small_string_max_size<char>() + 1, 100));
+	const char* data = s1.data();
+	const auto size = s1.size();
+
+	// Overwrite the null terminator, then write a new one
+	s1[size] = 'x';
+	s1.commit(1);
+	s1.emplace_back('y');
+	s1[s1.size()] = '\0';
+
+	EXPECT_EQ(s1.data(), data);
+	EXPECT_EQ(s1.size(), size + 2);
+	EXPECT_EQ(s1.spare_capacity(), s1.capacity() - size - 2);
+	EXPECT_EQ(std::char_traits<char>::length(s1.data()), size + 2);
+}
+
+TEST_F(StringTest, AdoptCharLong)
+{
+	auto s1 = generateString<char>(bt::small_string_max_size<char>() + 10);
+	const auto size = s1.size();
+	const auto capacity = s1.capacity();
+	const char* data = s1.data();
+
+	auto s2 = bt::adopt(bt::try_steal(s1));
+	EXPECT_EQ(s2.data(), data);
+	EXPECT_EQ(s2.size(), size);
+	EXPECT_EQ(s2.capacity(), capacity);
+	EXPECT_EQ(bt::uses_large_buffer(s2), true);
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	EXPECT_EQ(s2, generateString<char>(size));
+
+	// The adopted buffer is released normally when the string grows
+	s2.append(capacity, 'x');
+	EXPECT_EQ(s2.size(), size + capacity);
+	EXPECT_EQ(s2[size], 'x');
+}
+
+TEST_F(StringTest, AdoptCharSmall)
+{
+	auto buffer = bt::buffer<char>{std::allocator<char>{}.allocate(4), 0, 4};
+	std::char_traits<char>::copy(buffer.data(), "abc", 4);
+	buffer.commit(3);
+
+	auto s1 = bt::adopt(std::move(buffer));
+	EXPECT_EQ(s1, "abc");
+	EXPECT_EQ(bt::uses_large_buffer(s1), false);
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+}
+
+TEST_F(StringTest, AdoptCharNoTerminator)
+{
+	// No room for the null terminator, so the buffer is copied
+	auto buffer = bt::buffer<char>{std::allocator<char>{}.allocate(64), 0, 64};
+	for (int i = 0; i < 64; ++i) { buffer.emplace_back('a'); }
+
+	counter_.reset();
+	auto s1 = bt::adopt(std::move(buffer));
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+	// assign() may round the copy's capacity up
+	BYTES_EXPECT_GE(s1.capacity() + 1);
+	EXPECT_EQ(s1, std::string(64, 'a'));
+	EXPECT_EQ(buffer, nullptr);
+}
+
+TEST_F(StringTest, AdoptChar32Long)
+{
+	auto s1 = generateString<char32_t>(bt::small_string_max_size<char32_t>() + 1);
+	const auto size = s1.size();
+	const auto capacity = s1.capacity();
+
+	auto s2 = bt::adopt(bt::steal(std::move(s1)));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(s2.size(), size);
+	EXPECT_EQ(s2.capacity(), capacity);
+	EXPECT_EQ(s2, generateString<char32_t>(size));
+}
+
+TEST_F(StringTest, StealMallocLong)
+{
+	bt::string s1(100, 'a');
+	const char* data = s1.data();
+
+	auto s2 = bt::steal(std::move(s1));
+	static_assert(std::is_same_v<decltype(s2), bt::buffer<char, bt::malloc_allocator<char>>>);
+	EXPECT_EQ(s2.get(), data);
+	EXPECT_EQ(bt::uses_large_buffer(s1), false);
+
+	// The stolen pointer is owned by malloc, so C code may realloc() and free() it
+	auto p = static_cast<char*>(std::realloc(s2.release(), 201));
+	ASSERT_NE(p, nullptr);
+	std::char_traits<char>::copy(p + 100, std::string(100, 'b').c_str(), 101);
+	EXPECT_EQ(std::char_traits<char>::length(p), 200);
+	std::free(p);
+}
+
+TEST_F(StringTest, StealMallocSmall)
+{
+	// Small strings are copied into a buffer allocated by malloc
+	char32_t* p = bt::steal(bt::u32string{U"abc"}).release();
+	ALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(std::char_traits<char32_t>::compare(p, U"abc", 4), 0);
+	std::free(p);
+}
+
+TEST_F(StringTest, AdoptMalloc)
+{
+	auto s1 = bt::adopt(bt::steal(bt::string(100, 'a')));
+	static_assert(std::is_same_v<decltype(s1), bt::string>);
+	EXPECT_EQ(bt::uses_large_buffer(s1), true);
+	EXPECT_EQ(std::string_view{s1}, std::string(100, 'a'));
+}
+
+TEST_F(StringTest, StealPolicySlackRatio)
+{
+	auto s1 = generateString<char>(200, 1000);
+	const auto capacity = s1.capacity();
+
+	// More than half of the buffer is unused, so it is copied tightly
+	auto b1 = bt::steal(std::move(s1), bt::copy_if_slack_exceeds_ratio{0.5});
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+	BYTES_EXPECT_EQ(201);
+	EXPECT_EQ(b1.size(), 200);
+	EXPECT_EQ(b1.capacity(), 201);
+	EXPECT_EQ(std::string_view(b1.get(), b1.size()), generateString<char>(200));
+	EXPECT_EQ(b1.get()[200], '\0');
+	EXPECT_TRUE(s1.empty());
+
+	// A looser ratio steals the buffer
+	auto s2 = generateString<char>(200, 1000);
+	const char* data = s2.data();
+	auto b2 = bt::steal(std::move(s2), bt::copy_if_slack_exceeds_ratio{0.9});
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(b2.get(), data);
+	EXPECT_EQ(b2.capacity(), capacity + 1);
+}
+
+TEST_F(StringTest, StealPolicySlackBytes)
+{
+	auto s1 = generateString<char16_t>(100, 1000);
+	const char16_t* data = s1.data();
+
+	auto b1 = bt::steal(std::move(s1), bt::copy_if_slack_exceeds_bytes{1024});
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+	BYTES_EXPECT_EQ(101 * sizeof(char16_t));
+	EXPECT_NE(b1.get(), data);
+	EXPECT_EQ(b1.capacity(), 101);
+	EXPECT_EQ(std::u16string_view(b1.get(), b1.size()), generateString<char16_t>(100));
+
+	auto s2 = generateString<char16_t>(100, 1000);
+	data = s2.data();
+	auto b2 = bt::steal(std::move(s2), bt::copy_if_slack_exceeds_bytes{4096});
+	ALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(b2.get(), data);
+}
+
+TEST_F(StringTest, StealPolicySmall)
+{
+	// Small strings are copied regardless of the policy
+	auto b1 = bt::steal(generateString<char>(2), bt::always_steal{});
+	EXPECT_EQ(b1.size(), 2);
+	EXPECT_EQ(b1.capacity(), 3);
+
+	// Any callable may be used as a policy
+	auto s2 = generateString<char>(100);
+	const char* data = s2.data();
+	auto b2 = bt::steal(std::move(s2), [](std::size_t used, std::size_t capacity) { return used <= capacity; });
+	EXPECT_EQ(b2.get(), data);
+}
+
+TEST_F(StringTest, StealInlineSmall)
+{
+	const auto size = bt::small_string_max_size<char>();
+	auto s1 = generateString<char>(size);
+
+	auto r1 = bt::steal_inline(std::move(s1));
+	EXPECT_TRUE(r1.is_inline());
+	EXPECT_EQ(r1.size, size);
+	EXPECT_EQ(r1.capacity, 0);
+	EXPECT_EQ(r1.view(), generateString<char>(size));
+	EXPECT_EQ(r1.data()[size], '\0');
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	// The inline copy moves along with the result
+	auto r2 = r1;
+	EXPECT_EQ(r2.data(), r2.inline_data);
+	EXPECT_EQ(r2.view(), generateString<char>(size));
+	r2.reset();
+}
+
+TEST_F(StringTest, StealInlineLong)
+{
+	auto s1 = generateString<char16_t>(100);
+	const char16_t* data = s1.data();
+	const auto capacity = s1.capacity();
+
+	auto r1 = bt::steal_inline(std::move(s1));
+	EXPECT_FALSE(r1.is_inline());
+	EXPECT_EQ(r1.heap, data);
+	EXPECT_EQ(r1.size, 100);
+	EXPECT_EQ(r1.capacity, capacity + 1);
+	EXPECT_TRUE(s1.empty());
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	r1.reset();
+	EXPECT_TRUE(r1.is_inline());
+	EXPECT_EQ(r1.size, 0);
+	DEALLOC_EXPECT_EQ(1);
+}
+
+#if defined(__cpp_lib_memory_resource)
+
+namespace {
+
+//! Forwards to the default resource, counting outstanding bytes
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	std::size_t bytes = 0;
+
+private:
+	auto do_allocate(std::size_t n, std::size_t alignment) -> void* override
+	{
+		bytes += n;
+		return std::pmr::get_default_resource()->allocate(n, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t n, std::size_t alignment) override
+	{
+		bytes -= n;
+		std::pmr::get_default_resource()->deallocate(p, n, alignment);
+	}
+
+	auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override
+	{
+		return this == &other;
+	}
+};
+
+} // namespace
+
+TEST_F(StringTest, StealPmrLong)
+{
+	CountingResource resource;
+	{
+		std::pmr::string s1{100, 'a', &resource};
+		const char* data = s1.data();
+		const auto capacity = s1.capacity();
+		const auto bytes = resource.bytes;
+
+		auto s2 = bt::steal(std::move(s1));
+		static_assert(std::is_same_v<decltype(s2), bt::buffer<char, std::pmr::polymorphic_allocator<char>>>);
+		EXPECT_EQ(s2.get(), data);
+		EXPECT_EQ(s2.size(), 100);
+		EXPECT_EQ(s2.capacity(), capacity + 1);
+		EXPECT_EQ(s2.get_allocator().resource(), &resource);
+		EXPECT_EQ(resource.bytes, bytes);
+
+		EXPECT_TRUE(s1.empty());
+		EXPECT_EQ(bt::uses_large_buffer(s1), false);
+	}
+	// The buffer is returned to the string's memory resource
+	EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(StringTest, StealPmrSmall)
+{
+	CountingResource resource;
+	{
+		std::pmr::u16string s1{u"abc", &resource};
+
+		auto s2 = bt::steal(std::move(s1));
+		EXPECT_EQ(s2.size(), 3);
+		EXPECT_EQ(s2.capacity(), 4);
+		EXPECT_EQ(s2.get_allocator().resource(), &resource);
+		EXPECT_EQ(resource.bytes, 4 * sizeof(char16_t));
+	}
+	EXPECT_EQ(resource.bytes, 0);
+}
+
+TEST_F(StringTest, AdoptPmr)
+{
+	CountingResource resource;
+	{
+		std::pmr::string s1{100, 'a', &resource};
+		const char* data = s1.data();
+
+		auto s2 = bt::adopt(bt::steal(std::move(s1)));
+		static_assert(std::is_same_v<decltype(s2), std::pmr::string>);
+		EXPECT_EQ(s2.data(), data);
+		EXPECT_EQ(std::string_view{s2}, std::string(100, 'a'));
+		EXPECT_EQ(s2.get_allocator().resource(), &resource);
+
+		s2.append(200, 'b');
+	}
+	EXPECT_EQ(resource.bytes, 0);
+}
+
+#endif // __cpp_lib_memory_resource
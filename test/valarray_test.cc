@@ -0,0 +1,79 @@
+/*
+ * valarray_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/valarray.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+#include <valarray>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for stealing valarray buffers
+class ValarrayTest : public ::testing::Test
+{
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(ValarrayTest, Doubles)
+{
+	auto v1 = std::valarray<double>(1.5, 1000);
+	v1[999] = 2.5;
+	const double* data = &v1[0];
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(v1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+
+	EXPECT_EQ(v1.size(), 0);
+	EXPECT_EQ(b1.data(), data);
+	EXPECT_EQ(b1.size(), 1000);
+	EXPECT_EQ(b1.capacity(), 1000);
+	EXPECT_EQ(b1[0], 1.5);
+	EXPECT_EQ(b1[999], 2.5);
+
+	// The valarray is still usable
+	v1.resize(10, 1.0);
+	EXPECT_EQ(v1.sum(), 10.0);
+
+	b1.reset();
+	DEALLOC_EXPECT_EQ(1);
+}
+
+TEST_F(ValarrayTest, Empty)
+{
+	auto v1 = std::valarray<std::int32_t>{};
+	auto b1 = bt::steal(std::move(v1));
+	EXPECT_EQ(b1, nullptr);
+	EXPECT_EQ(b1.size(), 0);
+}
+
+TEST_F(ValarrayTest, Expression)
+{
+	const auto a = std::valarray<std::int32_t>{1, 2, 3};
+	auto v1 = std::valarray<std::int32_t>(a * 2 + 1);
+
+	auto b1 = bt::steal(std::move(v1));
+	ASSERT_EQ(b1.size(), 3);
+	EXPECT_EQ(b1[0], 3);
+	EXPECT_EQ(b1[2], 7);
+}
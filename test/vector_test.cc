@@ -0,0 +1,289 @@
+/*
+ * vector_test.cc
+ *
+ * Copyright (c) 2025 Dalton Messmer <messmer.dalton/at/gmail.com>
+ * This file is part of the BufferThief library.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "allocation_counter.hh"
+
+#include <bufferthief/vector.hh>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(BT_COPY_BUFFERS)
+#	error "BufferThief must not be configured with BT_COPY_BUFFERS for these tests"
+#endif
+
+//! Test fixture for vectors
+class VectorTest : public ::testing::Test
+{
+public:
+	template<typename T>
+	auto generateVector(std::size_t length, std::size_t reserve = 0) -> std::vector<T>
+	{
+		std::vector<T> ret;
+		if (reserve > 0) {
+			ret.reserve(reserve);
+		}
+
+		for (std::size_t i = 0; i < length; ++i) {
+			ret.push_back(static_cast<T>(i));
+		}
+
+		counter_.reset();
+
+		return ret;
+	}
+
+protected:
+	AllocationCounter counter_;
+};
+
+///////////////////////////////////////////////////
+
+TEST_F(VectorTest, StealEmpty)
+{
+	auto v1 = bt::steal(generateVector<float>(0));
+	EXPECT_EQ(v1, nullptr);
+
+	auto v2 = generateVector<float>(0, 8);
+	const float* data = v2.data();
+	auto v3 = bt::steal(std::move(v2));
+	EXPECT_EQ(v3.get(), data);
+	EXPECT_EQ(v2.data(), nullptr);
+	EXPECT_EQ(v2.capacity(), 0);
+}
+
+TEST_F(VectorTest, StealFloat)
+{
+	auto v1 = generateVector<float>(1000);
+	const float* data = v1.data();
+
+	auto v2 = bt::steal(std::move(v1));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(v2.get(), data);
+	EXPECT_EQ(v2[0], 0.f);
+	EXPECT_EQ(v2[999], 999.f);
+
+	EXPECT_TRUE(v1.empty());
+	EXPECT_EQ(v1.data(), nullptr);
+	EXPECT_EQ(v1.capacity(), 0);
+
+	// The vector is still usable after its buffer is stolen
+	v1.push_back(1.f);
+	EXPECT_EQ(v1.size(), 1);
+	EXPECT_EQ(v1[0], 1.f);
+}
+
+TEST_F(VectorTest, StealInt64)
+{
+	auto v1 = generateVector<std::int64_t>(3, 100);
+	const std::int64_t* data = v1.data();
+
+	auto v2 = bt::steal(std::move(v1));
+	EXPECT_EQ(v2.get(), data);
+	EXPECT_EQ(v2[2], 2);
+	EXPECT_EQ(v1.capacity(), 0);
+}
+
+TEST_F(VectorTest, StealSizeAndCapacity)
+{
+	auto v1 = bt::steal(generateVector<float>(10, 32));
+	EXPECT_EQ(v1.size(), 10);
+	EXPECT_EQ(v1.capacity(), 32);
+	EXPECT_EQ(v1.spare_capacity(), 22);
+
+	// Append in place without reallocating
+	const float* data = v1.data();
+	v1.emplace_back(10.f);
+	EXPECT_EQ(v1.data(), data);
+	EXPECT_EQ(v1.size(), 11);
+	EXPECT_EQ(v1[10], 10.f);
+}
+
+TEST_F(VectorTest, StealNonTrivial)
+{
+	std::vector<std::string> v1;
+	v1.reserve(4);
+	v1.emplace_back(100, 'a');
+	v1.emplace_back(100, 'b');
+	const std::string b(100, 'b');
+	const std::string c(100, 'c');
+
+	counter_.reset();
+	{
+		auto v2 = bt::steal(std::move(v1));
+		ALLOC_EXPECT_EQ(0);
+		EXPECT_EQ(v2.size(), 2);
+		EXPECT_EQ(v2.capacity(), 4);
+		EXPECT_EQ(v2[1], b);
+
+		v2.emplace_back(100, 'c');
+		EXPECT_EQ(v2[2], c);
+	}
+	// The elements are destroyed along with the buffer
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(4);
+}
+
+TEST_F(VectorTest, StealPolicy)
+{
+	std::vector<std::int64_t> v1(10, 7);
+	v1.reserve(1000);
+
+	counter_.reset();
+	auto b1 = bt::steal(std::move(v1), bt::copy_if_slack_exceeds_ratio{0.5});
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+	BYTES_EXPECT_EQ(10 * sizeof(std::int64_t));
+	EXPECT_EQ(b1.size(), 10);
+	EXPECT_EQ(b1.capacity(), 10);
+	EXPECT_EQ(b1[9], 7);
+	EXPECT_EQ(v1.data(), nullptr);
+
+	std::vector<std::int64_t> v2(10, 7);
+	v2.reserve(1000);
+	const std::int64_t* data = v2.data();
+	auto b2 = bt::steal(std::move(v2), bt::copy_if_slack_exceeds_bytes{8000});
+	EXPECT_EQ(b2.get(), data);
+	EXPECT_EQ(b2.capacity(), 1000);
+
+	// Reserved but empty vectors are not stolen
+	std::vector<std::int64_t> v3;
+	v3.reserve(1000);
+	auto b3 = bt::steal(std::move(v3), bt::copy_if_slack_exceeds_bytes{0});
+	EXPECT_EQ(b3, nullptr);
+	EXPECT_EQ(v3.capacity(), 0);
+}
+
+TEST_F(VectorTest, StealPolicyNonTrivial)
+{
+	std::vector<std::string> v1;
+	v1.reserve(100);
+	v1.emplace_back(100, 'a');
+	const char* data = v1[0].data();
+
+	// The elements are moved into the copy
+	counter_.reset();
+	auto b1 = bt::steal(std::move(v1), bt::copy_if_slack_exceeds_ratio{0.5});
+	ALLOC_EXPECT_EQ(1);
+	DEALLOC_EXPECT_EQ(1);
+	BYTES_EXPECT_EQ(sizeof(std::string));
+	EXPECT_EQ(b1.capacity(), 1);
+	EXPECT_EQ(b1[0].data(), data);
+	EXPECT_EQ(v1.capacity(), 0);
+}
+
+TEST_F(VectorTest, AdoptFloat)
+{
+	auto v1 = generateVector<float>(100, 150);
+	const auto size = v1.size();
+	const auto capacity = v1.capacity();
+	const float* data = v1.data();
+
+	auto v2 = bt::adopt_vector(bt::steal(std::move(v1)));
+	ALLOC_EXPECT_EQ(0);
+	DEALLOC_EXPECT_EQ(0);
+	EXPECT_EQ(v2.data(), data);
+	EXPECT_EQ(v2.size(), size);
+	EXPECT_EQ(v2.capacity(), capacity);
+	EXPECT_EQ(v2, generateVector<float>(size));
+
+	// The adopted buffer is released normally when the vector grows
+	v2.resize(capacity + 1, 1.f);
+	EXPECT_EQ(v2.size(), capacity + 1);
+	EXPECT_EQ(v2[size], 1.f);
+}
+
+TEST_F(VectorTest, AdoptEmpty)
+{
+	auto v1 = bt::adopt_vector(bt::buffer<float>{});
+	EXPECT_TRUE(v1.empty());
+	EXPECT_EQ(v1.data(), nullptr);
+}
+
+TEST_F(VectorTest, StealMalloc)
+{
+	bt::vector<double> v1(100, 1.0);
+	const double* data = v1.data();
+
+	auto v2 = bt::steal(std::move(v1));
+	static_assert(std::is_same_v<decltype(v2), bt::buffer<double, bt::malloc_allocator<double>>>);
+	EXPECT_EQ(v2.get(), data);
+	EXPECT_EQ(v1.data(), nullptr);
+
+	// The stolen pointer is owned by malloc
+	auto p = static_cast<double*>(std::realloc(v2.release(), 200 * sizeof(double)));
+	ASSERT_NE(p, nullptr);
+	EXPECT_EQ(p[99], 1.0);
+	std::free(p);
+}
+
+TEST_F(VectorTest, AdoptMalloc)
+{
+	auto v1 = bt::adopt_vector(bt::steal(bt::vector<int>{1, 2, 3}));
+	static_assert(std::is_same_v<decltype(v1), bt::vector<int>>);
+	EXPECT_EQ(v1.size(), 3);
+	EXPECT_EQ(v1[2], 3);
+}
+
+#if defined(__cpp_lib_memory_resource)
+
+TEST_F(VectorTest, StealPmr)
+{
+	std::pmr::monotonic_buffer_resource arena;
+
+	std::pmr::vector<std::int32_t> v1{&arena};
+	v1.assign({1, 2, 3, 4});
+	const std::int32_t* data = v1.data();
+
+	auto v2 = bt::steal(std::move(v1));
+	static_assert(std::is_same_v<decltype(v2), bt::buffer<std::int32_t, std::pmr::polymorphic_allocator<std::int32_t>>>);
+	EXPECT_EQ(v2.get(), data);
+	EXPECT_EQ(v2.size(), 4);
+	EXPECT_EQ(v2[3], 4);
+	EXPECT_EQ(v2.get_allocator().resource(), &arena);
+	EXPECT_EQ(v1.data(), nullptr);
+
+	// The vector keeps its allocator and is still usable
+	v1.push_back(5);
+	EXPECT_EQ(v1.get_allocator().resource(), &arena);
+}
+
+TEST_F(VectorTest, AdoptPmr)
+{
+	std::pmr::monotonic_buffer_resource arena;
+
+	std::pmr::vector<std::pmr::string> v1{&arena};
+	v1.reserve(4);
+	v1.emplace_back(100, 'a');
+	const std::pmr::string* data = v1.data();
+
+	auto v2 = bt::adopt_vector(bt::steal(std::move(v1)));
+	static_assert(std::is_same_v<decltype(v2), std::pmr::vector<std::pmr::string>>);
+	EXPECT_EQ(v2.data(), data);
+	EXPECT_EQ(v2.capacity(), 4);
+	EXPECT_EQ(std::string_view{v2[0]}, std::string(100, 'a'));
+	EXPECT_EQ(v2.get_allocator().resource(), &arena);
+
+	// Uses-allocator construction still works for elements of the adopted vector
+	v2.emplace_back(100, 'b');
+	EXPECT_EQ(v2[1].get_allocator().resource(), &arena);
+}
+
+#endif // __cpp_lib_memory_resource